@@ -112,7 +112,7 @@ project "ImGui"
 project "BlueSpheresForever"
     location(_ACTION)
     language "C++"
-    cppdialect "C++17"
+    cppdialect "C++20"
 
     objdir "bin-int/%{cfg.buildcfg}/%{prj.name}"
     targetdir "bin/%{cfg.buildcfg}/%{prj.name}"
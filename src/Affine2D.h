@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BSF_AFFINE2D_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define BSF_AFFINE2D_NEON
+#include <arm_neon.h>
+#endif
+
+namespace bsf
+{
+	// 2D affine transform, the top 2x3 part of a 3x3 matrix:
+	// | A C Tx |
+	// | B D Ty |
+	// Composes like a matrix, the transforms are applied from the right (like glm::translate etc.)
+	struct Affine2D
+	{
+		float A = 1.0f, B = 0.0f, C = 0.0f, D = 1.0f, Tx = 0.0f, Ty = 0.0f;
+
+		Affine2D operator*(const Affine2D& o) const
+		{
+			return {
+				A * o.A + C * o.B, B * o.A + D * o.B,
+				A * o.C + C * o.D, B * o.C + D * o.D,
+				A * o.Tx + C * o.Ty + Tx, B * o.Tx + D * o.Ty + Ty
+			};
+		}
+
+		glm::vec2 operator*(const glm::vec2& p) const
+		{
+			return { A * p.x + C * p.y + Tx, B * p.x + D * p.y + Ty };
+		}
+
+		Affine2D& Translate(const glm::vec2& t)
+		{
+			Tx += A * t.x + C * t.y;
+			Ty += B * t.x + D * t.y;
+			return *this;
+		}
+
+		Affine2D& Scale(const glm::vec2& s)
+		{
+			A *= s.x; B *= s.x;
+			C *= s.y; D *= s.y;
+			return *this;
+		}
+
+		Affine2D& Rotate(float angle)
+		{
+			const float c = std::cos(angle), s = std::sin(angle);
+			return *this = *this * Affine2D{ c, s, -s, c, 0.0f, 0.0f };
+		}
+	};
+
+	inline void TransformPoints4Scalar(const Affine2D& m, const glm::vec2* in, glm::vec2* out)
+	{
+		for (uint32_t i = 0; i < 4; i++)
+			out[i] = m * in[i];
+	}
+
+	// Transforms 4 points at once (a quad), in and out can be the same
+	inline void TransformPoints4(const Affine2D& m, const glm::vec2* in, glm::vec2* out)
+	{
+		static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "glm::vec2 must be tightly packed");
+
+#if defined(BSF_AFFINE2D_SSE)
+		const float* src = reinterpret_cast<const float*>(in);
+		float* dst = reinterpret_cast<float*>(out);
+
+		const __m128 p01 = _mm_loadu_ps(src);     // x0 y0 x1 y1
+		const __m128 p23 = _mm_loadu_ps(src + 4); // x2 y2 x3 y3
+
+		const __m128 xs = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 ys = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+
+		const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, _mm_set1_ps(m.A)), _mm_mul_ps(ys, _mm_set1_ps(m.C))), _mm_set1_ps(m.Tx));
+		const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, _mm_set1_ps(m.B)), _mm_mul_ps(ys, _mm_set1_ps(m.D))), _mm_set1_ps(m.Ty));
+
+		_mm_storeu_ps(dst, _mm_unpacklo_ps(rx, ry));
+		_mm_storeu_ps(dst + 4, _mm_unpackhi_ps(rx, ry));
+#elif defined(BSF_AFFINE2D_NEON)
+		const float32x4x2_t p = vld2q_f32(reinterpret_cast<const float*>(in)); // Deinterleaved: xs, ys
+
+		float32x4x2_t r;
+		r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m.Tx), p.val[0], m.A), p.val[1], m.C);
+		r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m.Ty), p.val[0], m.B), p.val[1], m.D);
+
+		vst2q_f32(reinterpret_cast<float*>(out), r);
+#else
+		TransformPoints4Scalar(m, in, out);
+#endif
+	}
+}
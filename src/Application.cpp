@@ -19,28 +19,33 @@ namespace bsf
   {
     double x, y;
     glfwGetCursorPos(window, &x, &y);
-    BD_APP(window)->Wheel.Emit({(float)xoffset, (float)yoffset, (float)x, (float)y});
+    BD_APP(window)->QueueInput({InputEvent::EType::Wheel, WheelEvent{(float)xoffset, (float)yoffset, (float)x, (float)y}});
   }
 
   static void GLFW_Key(GLFWwindow *window, int key, int scancode, int action, int mods)
   {
+    const auto now = BD_APP(window)->GetInputTimestamp();
+
     if (action == GLFW_PRESS || action == GLFW_REPEAT)
     {
-      BD_APP(window)->KeyPressed.Emit({key, action == GLFW_REPEAT});
+      BD_APP(window)->QueueInput({InputEvent::EType::KeyPressed, KeyPressedEvent{key, action == GLFW_REPEAT, now}});
     }
     else
     {
-      BD_APP(window)->KeyReleased.Emit({key});
+      BD_APP(window)->QueueInput({InputEvent::EType::KeyReleased, KeyReleasedEvent{key, now}});
     }
   }
 
   static void GLFW_CursorPos(GLFWwindow *window, double x, double y)
   {
-    BD_APP(window)->MouseMoved.Emit({float(x), float(y), 0, 0, MouseButton::None});
+    const auto now = BD_APP(window)->GetInputTimestamp();
+    BD_APP(window)->QueueInput({InputEvent::EType::MouseMoved, MouseEvent{float(x), float(y), 0, 0, MouseButton::None, now}});
   }
 
   static void GLFW_MouseButton(GLFWwindow *window, int button, int action, int mods)
   {
+    const auto now = BD_APP(window)->GetInputTimestamp();
+
     double x, y;
     glfwGetCursorPos(window, &x, &y);
 
@@ -61,22 +66,22 @@ namespace bsf
 
     if (action == GLFW_PRESS)
     {
-      BD_APP(window)->MousePressed.Emit({float(x), float(y), 0, 0, appButton});
+      BD_APP(window)->QueueInput({InputEvent::EType::MousePressed, MouseEvent{float(x), float(y), 0, 0, appButton, now}});
     }
     else if (action == GLFW_RELEASE)
     {
-      BD_APP(window)->MouseReleased.Emit({float(x), float(y), 0, 0, appButton});
+      BD_APP(window)->QueueInput({InputEvent::EType::MouseReleased, MouseEvent{float(x), float(y), 0, 0, appButton, now}});
     }
   }
 
   static void GLFW_WindowSize(GLFWwindow *window, int w, int h)
   {
-    BD_APP(window)->WindowResized.Emit({float(w), float(h)});
+    BD_APP(window)->QueueInput({InputEvent::EType::WindowResized, WindowResizedEvent{float(w), float(h)}});
   }
 
   static void GLFW_Char(GLFWwindow *window, uint32_t codePoint)
   {
-    BD_APP(window)->CharacterTyped.Emit({(char)codePoint});
+    BD_APP(window)->QueueInput({InputEvent::EType::CharacterTyped, CharacterTypedEvent{(char)codePoint}});
   }
 
 #undef BD_APP
@@ -129,6 +134,9 @@ namespace bsf
     // Initialize log
     BSF_LOG_INIT();
 
+    if (!m_TraceFile.empty())
+      TraceRecorder::Get().Start(m_TraceFile);
+
     if (!glfwInit())
     {
       BSF_ERROR("Can't initialize GLFW");
@@ -164,8 +172,6 @@ namespace bsf
     glfwSetKeyCallback(m_Window, &GLFW_Key);
     glfwSetCharCallback(m_Window, &GLFW_Char);
 
-    glfwSwapInterval(0);
-
     // Init diagnostic
     BSF_DIAGNOSTIC_INIT(this, m_Window);
 
@@ -185,11 +191,19 @@ namespace bsf
     auto startTime = std::chrono::high_resolution_clock::now();
     auto prevTime = std::chrono::high_resolution_clock::now();
     auto currTime = std::chrono::high_resolution_clock::now();
+    uint32_t frameCount = 0;
 
     while (!glfwWindowShouldClose(m_Window))
     {
+      const auto frameStart = std::chrono::high_resolution_clock::now();
+
       BSF_DIAGNOSTIC_BEGIN();
 
+      // Input is polled right before the update, so it isn't a whole frame pacing wait late
+      m_PrevPollTime = std::exchange(m_PollTime, std::chrono::steady_clock::now());
+      glfwPollEvents();
+      DispatchInput();
+
       {
         if (m_NextScene != nullptr)
         {
@@ -200,7 +214,7 @@ namespace bsf
           m_CurrentScene->OnAttach();
 
           // Reset time on scene change
-          startTime = prevTime = std::chrono::high_resolution_clock::now();
+          startTime = prevTime = m_LastInputTime = std::chrono::high_resolution_clock::now();
         }
 
         auto now = std::chrono::high_resolution_clock::now();
@@ -216,15 +230,85 @@ namespace bsf
 
       BSF_DIAGNOSTIC_END();
 
+      // Keep trace buffers small
+      if (TraceRecorder::IsEnabled() && ++frameCount % 60 == 0)
+        TraceRecorder::Get().Flush();
+
+      const auto swapStart = std::chrono::high_resolution_clock::now();
+
       glfwSwapBuffers(m_Window);
 
-      glfwPollEvents();
+      const auto swapEnd = std::chrono::high_resolution_clock::now();
+
+      // Frame pacing
+      {
+        const bool inactive = swapEnd - m_LastInputTime > s_IdleInputDelay &&
+          !m_CurrentScene->IsAnimating() && !m_CurrentScene->HasScheduledTasks();
+        const bool idle = m_LowPowerIdle && (inactive || glfwGetWindowAttrib(m_Window, GLFW_ICONIFIED));
+        const uint32_t frameRate = idle && (m_FrameRateLimit == 0 || m_IdleFrameRate < m_FrameRateLimit) ? m_IdleFrameRate : m_FrameRateLimit;
+
+        m_FramePacer.SetTargetFrameRate(float(frameRate));
+        m_FramePacer.Wait();
+      }
+
+      using Milliseconds = std::chrono::duration<float, std::milli>;
+      m_FrameTimes.Record(*m_CurrentScene,
+        Milliseconds(swapStart - frameStart).count(),
+        Milliseconds(swapEnd - swapStart).count(),
+        Milliseconds(std::chrono::high_resolution_clock::now() - frameStart).count());
     }
 
+    BSF_INFO("Frame times:");
+    m_FrameTimes.WriteReport();
+
     m_CurrentScene->ClearSubscriptions();
     m_CurrentScene->OnDetach();
 
     m_CurrentScene = nullptr;
+
+    TraceRecorder::Get().Stop();
+  }
+
+  void Application::DispatchInput()
+  {
+    BSF_DIAGNOSTIC_FUNC();
+
+    m_InputQueue.DrainRawMouseMoves([&](const MouseEvent &evt) { RawMouseMoved.Emit(evt); });
+
+    // Raw samples are collected only while somebody wants them
+    m_InputQueue.SetKeepRawMouseMoves(RawMouseMoved.HasSubscribers());
+
+    m_InputQueue.Drain([&](const InputEvent &evt) {
+      m_LastInputTime = std::chrono::high_resolution_clock::now();
+
+      switch (evt.Type)
+      {
+      case InputEvent::EType::KeyPressed:
+        KeyPressed.Emit(std::get<KeyPressedEvent>(evt.Data));
+        break;
+      case InputEvent::EType::KeyReleased:
+        KeyReleased.Emit(std::get<KeyReleasedEvent>(evt.Data));
+        break;
+      case InputEvent::EType::CharacterTyped:
+        CharacterTyped.Emit(std::get<CharacterTypedEvent>(evt.Data));
+        break;
+      case InputEvent::EType::MousePressed:
+        MousePressed.Emit(std::get<MouseEvent>(evt.Data));
+        break;
+      case InputEvent::EType::MouseReleased:
+        MouseReleased.Emit(std::get<MouseEvent>(evt.Data));
+        break;
+      case InputEvent::EType::MouseMoved:
+        MouseMoved.Emit(std::get<MouseEvent>(evt.Data));
+        break;
+      case InputEvent::EType::Wheel:
+        Wheel.Emit(std::get<WheelEvent>(evt.Data));
+        break;
+      case InputEvent::EType::WindowResized:
+        WindowResized.Emit(std::get<WindowResizedEvent>(evt.Data));
+        break;
+      }
+    });
   }
 
   void Application::GotoScene(std::shared_ptr<Scene> &&scene)
@@ -256,6 +340,12 @@ namespace bsf
   {
     auto config = Config::Load();
 
+    glfwSwapInterval(config.VSync ? 1 : 0);
+
+    m_FrameRateLimit = config.FrameRateLimit;
+    m_IdleFrameRate = config.IdleFrameRate;
+    m_LowPowerIdle = config.LowPowerIdle;
+
     if (config.Fullscreen)
     {
       glfwSetWindowMonitor(m_Window, glfwGetPrimaryMonitor(), 100, 100, config.DisplayMode.Width, config.DisplayMode.Height, GLFW_DONT_CARE);
@@ -268,22 +358,24 @@ namespace bsf
 
   void Application::RunScheduledTasks(const Time &time, const Ref<Scene> &scene, ESceneTaskEvent evt)
   {
-    auto &tasks = scene->m_ScheduledTasks[evt];
+    auto &tasks = scene->m_ScheduledTasks[size_t(evt)];
 
-    for (auto taskIt = tasks.begin(); taskIt != tasks.end();)
+    for (SceneTask *task = tasks.Front(); task != nullptr;)
     {
-      auto &task = (*taskIt);
       task->m_Application = this;
-      task->m_Scene = scene.get();
       task->m_Event = evt;
       task->CallUpdateFn(time);
       if (task->IsDone())
       {
         task->CallDoneFn();
-        taskIt = tasks.erase(taskIt);
+        // The done function might have scheduled other tasks, so get the next one after
+        SceneTask *next = task->m_Next;
+        tasks.Remove(task);
+        scene->ReleaseTask(task);
+        task = next;
       }
       else
-        ++taskIt;
+        task = task->m_Next;
     }
   }
 
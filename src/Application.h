@@ -3,6 +3,9 @@
 #include "Ref.h"
 #include "Scene.h"
 #include "EventEmitter.h"
+#include "FrameTiming.h"
+#include "FramePacer.h"
+#include "InputQueue.h"
 
 #include <glm/glm.hpp>
 
@@ -21,7 +24,8 @@ namespace bsf {
 
 		EventEmitter<MouseEvent> MousePressed;
 		EventEmitter<MouseEvent> MouseReleased;
-		EventEmitter<MouseEvent> MouseMoved;
+		EventEmitter<MouseEvent> MouseMoved; // Once per frame at most, see InputQueue
+		EventEmitter<MouseEvent> RawMouseMoved; // Every cursor sample, emitted before the frame input
 		EventEmitter<WheelEvent> Wheel;
 
 		EventEmitter<WindowResizedEvent> WindowResized;
@@ -45,22 +49,49 @@ namespace bsf {
 
 		AudioDevice& GetAudioDevice();
 
+		const FrameTimeTracker& GetFrameTimes() const { return m_FrameTimes; }
+		FrameTimeTracker& GetFrameTimes() { return m_FrameTimes; }
+
 		void LoadConfig();
 
+		// Capture a Chrome trace of the whole session (see TraceRecorder)
+		void SetTraceFile(const std::string& path) { m_TraceFile = path; }
+
 		void Start();
 		void GotoScene(const std::shared_ptr<Scene>& scene);
 		void GotoScene(std::shared_ptr<Scene>&& scene);
 
 		void Exit();
 
+		// Called by the window callbacks, the events are emitted at the beginning of the next frame
+		void QueueInput(const InputEvent& evt) { m_InputQueue.Push(evt); }
+
+		// Events are delivered only when polled, they happened at some point since the previous
+		// poll: the middle of that interval is the best estimate of when
+		InputTimestamp GetInputTimestamp() const { return m_PrevPollTime + (m_PollTime - m_PrevPollTime) / 2; }
+
 	private:
 
+		void DispatchInput();
+
+		// Time without input before a scene that isn't animating runs at the idle frame rate
+		static constexpr auto s_IdleInputDelay = std::chrono::milliseconds(500);
+
 		void RunScheduledTasks(const Time& time, const Ref<Scene>& scene, ESceneTaskEvent evt);
 
 		Ref<Scene> m_NextScene, m_CurrentScene;
 		Ref<Renderer2D> m_Renderer2D;
 		Ref<AudioDevice> m_AudioDevice;
 		GLFWwindow* m_Window;
+		std::string m_TraceFile;
+		FrameTimeTracker m_FrameTimes;
+		InputQueue m_InputQueue;
+
+		FramePacer m_FramePacer;
+		uint32_t m_FrameRateLimit = 0, m_IdleFrameRate = 0;
+		bool m_LowPowerIdle = false;
+		std::chrono::high_resolution_clock::time_point m_LastInputTime;
+		InputTimestamp m_PrevPollTime = std::chrono::steady_clock::now(), m_PollTime = m_PrevPollTime;
 	};
 
 }
\ No newline at end of file
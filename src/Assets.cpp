@@ -5,6 +5,7 @@
 #include "Model.h"
 #include "VertexArray.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
 #include "Log.h"
 #include "Common.h"
 #include "Font.h"
@@ -45,7 +46,6 @@ namespace bsf
 		m_Assets[AssetName::FontText] = MakeRef<Font>("assets/fonts/arial.ttf", 72.0f);
 
 		// Textures
-		m_Assets[AssetName::TexLogo] = loadTex2D("assets/textures/bs.png");
 
 		m_Assets[AssetName::TexWhite] = MakeRef<Texture2D>(0xffffffff);
 		m_Assets[AssetName::TexBlack] = MakeRef<Texture2D>(0xff000000);
@@ -63,7 +63,6 @@ namespace bsf
 		m_Assets[AssetName::TexRingMetallic] = CreateGray(0.1f);
 		m_Assets[AssetName::TexRingRoughness] = CreateGray(0.1f);
 
-		m_Assets[AssetName::TexRingSparkle] = loadTex2D("assets/textures/sparkle.png");
 
 		m_Assets[AssetName::TexBumperMetallic] = CreateGray(0.1f);
 		m_Assets[AssetName::TexBumperRoughness] = CreateGray(0.3f);
@@ -71,15 +70,32 @@ namespace bsf
 
 		m_Assets[AssetName::TexBRDFLut] = loadTex2D("assets/textures/ibl_brdf_lut.png");
 
-		m_Assets[AssetName::TexUISphere] = loadTex2D("assets/textures/sphere_ui.png");
-		m_Assets[AssetName::TexUIRing] = loadTex2D("assets/textures/ring_ui.png");
-		m_Assets[AssetName::TexUIAvoidSearch] = loadTex2D("assets/textures/avoid_search_ui.png");
-		m_Assets[AssetName::TexUIPosition] = loadTex2D("assets/textures/position_ui.png");
-		m_Assets[AssetName::TexUINew] = loadTex2D("assets/textures/new_ui.png");
-		m_Assets[AssetName::TexUIOpen] = loadTex2D("assets/textures/open_ui.png");
-		m_Assets[AssetName::TexUIDelete] = loadTex2D("assets/textures/delete_ui.png");
-		m_Assets[AssetName::TexUISave] = loadTex2D("assets/textures/save_ui.png");
-		m_Assets[AssetName::TexUIBack] = loadTex2D("assets/textures/back_ui.png");
+		// UI and sprite textures, only drawn by Renderer2D, are packed together so they share a texture unit
+		{
+			constexpr std::array<std::pair<AssetName, std::string_view>, 11> atlasTextures = {
+				std::make_pair(AssetName::TexLogo,			"assets/textures/bs.png"),
+				std::make_pair(AssetName::TexRingSparkle,	"assets/textures/sparkle.png"),
+				std::make_pair(AssetName::TexUISphere,		"assets/textures/sphere_ui.png"),
+				std::make_pair(AssetName::TexUIRing,		"assets/textures/ring_ui.png"),
+				std::make_pair(AssetName::TexUIAvoidSearch,	"assets/textures/avoid_search_ui.png"),
+				std::make_pair(AssetName::TexUIPosition,	"assets/textures/position_ui.png"),
+				std::make_pair(AssetName::TexUINew,			"assets/textures/new_ui.png"),
+				std::make_pair(AssetName::TexUIOpen,		"assets/textures/open_ui.png"),
+				std::make_pair(AssetName::TexUIDelete,		"assets/textures/delete_ui.png"),
+				std::make_pair(AssetName::TexUISave,		"assets/textures/save_ui.png"),
+				std::make_pair(AssetName::TexUIBack,		"assets/textures/back_ui.png"),
+			};
+
+			TextureAtlas atlas;
+
+			for (const auto& [name, fileName] : atlasTextures)
+				atlas.Add(fileName);
+
+			atlas.Build(TextureFilter::LinearMipmapLinear, TextureFilter::Linear);
+
+			for (uint32_t i = 0; i < atlasTextures.size(); i++)
+				m_Assets[atlasTextures[i].first] = atlas.Get(i);
+		}
 
 		// Sound
 		m_Assets[AssetName::SfxBlueSphere] = MakeRef<Audio>("assets/sound/bluesphere.wav");
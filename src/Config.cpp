@@ -32,12 +32,25 @@ namespace bsf
 		json = json::object();
 		json["displayMode"] = config.DisplayMode;
 		json["fullscreen"] = config.Fullscreen;
+		json["vsync"] = config.VSync;
+		json["frameRateLimit"] = config.FrameRateLimit;
+		json["lowPowerIdle"] = config.LowPowerIdle;
+		json["idleFrameRate"] = config.IdleFrameRate;
+		json["eventDrivenSimulation"] = config.EventDrivenSimulation;
 	}
 
 	void from_json(const json& json, Config& mode)
 	{
 		mode.DisplayMode = json["displayMode"].get<DisplayModeDescriptor>();
 		mode.Fullscreen = json["fullscreen"].get<bool>();
+
+		// Missing in older config files
+		const Config defaults = {};
+		mode.VSync = json.value("vsync", defaults.VSync);
+		mode.FrameRateLimit = json.value("frameRateLimit", defaults.FrameRateLimit);
+		mode.LowPowerIdle = json.value("lowPowerIdle", defaults.LowPowerIdle);
+		mode.IdleFrameRate = json.value("idleFrameRate", defaults.IdleFrameRate);
+		mode.EventDrivenSimulation = json.value("eventDrivenSimulation", defaults.EventDrivenSimulation);
 	}
 
 	bool operator==(const DisplayModeDescriptor& a, const DisplayModeDescriptor& b)
@@ -21,6 +21,16 @@ namespace bsf
 	{
 		DisplayModeDescriptor DisplayMode;
 		bool Fullscreen;
+
+		// Frame pacing, frame rates of 0 mean unlimited
+		bool VSync = true;
+		uint32_t FrameRateLimit = 0;
+		bool LowPowerIdle = true;
+		uint32_t IdleFrameRate = 30;
+
+		// GameLogic jumps from event to event instead of integrating every tick
+		bool EventDrivenSimulation = false;
+
 		bool Save() const;
 		static Config Load();
 	};
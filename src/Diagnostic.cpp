@@ -13,14 +13,403 @@
 #include "Assets.h"
 #include "Stage.h"
 #include "Config.h"
+#include "GameLogic.h"
+#include "GameSimulation.h"
+#include "Renderer2D.h"
+#include "Affine2D.h"
+#include "Texture.h"
 
 namespace bsf
 {
+	static constexpr std::string_view s_TraceFile = "trace.json";
+
+	static void BenchmarkEventEmitter()
+	{
+		// Emit cost of EventEmitter against the old std::list<std::function> storage
+		using Clock = std::chrono::steady_clock;
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+
+		constexpr uint32_t emits = 1000000;
+		const GameActionEvent evt = { EGameAction::RingCollected };
+
+		for (uint32_t subscribers : { 1u, 4u, 16u })
+		{
+			uint32_t sink = 0;
+			const auto handler = [&sink](const GameActionEvent& e) { sink += uint32_t(e.Action); };
+
+			EventEmitter<GameActionEvent> emitter;
+			std::list<std::function<void(const GameActionEvent&)>> reference;
+			std::vector<Unsubscribe> subscriptions;
+
+			for (uint32_t i = 0; i < subscribers; i++)
+			{
+				subscriptions.push_back(emitter.Subscribe(handler));
+				reference.push_back(handler);
+			}
+
+			auto t0 = Clock::now();
+			for (uint32_t i = 0; i < emits; i++)
+				emitter.Emit(evt);
+
+			auto t1 = Clock::now();
+			for (uint32_t i = 0; i < emits; i++)
+				for (auto& fn : reference)
+					fn(evt);
+
+			auto t2 = Clock::now();
+
+			BSF_INFO("EventEmitter, {0} subscribers: {1:.2f} ns/emit (std::list<std::function>: {2:.2f} ns/emit, sink: {3})", subscribers,
+				Milliseconds(t1 - t0).count() * 1e6f / emits, Milliseconds(t2 - t1).count() * 1e6f / emits, sink);
+
+			for (auto& unsub : subscriptions)
+				unsub();
+		}
+	}
+
+	static void BenchmarkRenderer2D(Application& app)
+	{
+		// Submit and draw 100k transformed quads (like the editor at low zoom), then the
+		// quad transform kernel alone against the scalar version
+		using Clock = std::chrono::steady_clock;
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+
+		constexpr uint32_t quads = 100000;
+
+		auto& renderer2d = app.GetRenderer2D();
+		const auto windowSize = app.GetWindowSize();
+
+		auto t0 = Clock::now();
+
+		renderer2d.Begin(glm::ortho(0.0f, windowSize.x, 0.0f, windowSize.y));
+		renderer2d.Color(Colors::Transparent);
+
+		for (uint32_t i = 0; i < quads; i++)
+		{
+			renderer2d.Push();
+			renderer2d.Translate({ float(i % 256) * 4.0f, float(i / 256 % 256) * 4.0f });
+			renderer2d.Rotate(0.1f);
+			renderer2d.DrawQuad({ 0.0f, 0.0f }, { 4.0f, 4.0f });
+			renderer2d.Pop();
+		}
+
+		renderer2d.End();
+		glFinish();
+
+		auto t1 = Clock::now();
+
+		std::vector<glm::vec2> points(quads * 4), transformed(quads * 4);
+		for (uint32_t i = 0; i < points.size(); i++)
+			points[i] = { float(i % 1024), float(i / 1024) };
+
+		Affine2D transform;
+		transform.Translate({ 10.0f, 20.0f }).Rotate(0.3f).Scale({ 2.0f, 2.0f });
+
+		auto t2 = Clock::now();
+		for (uint32_t i = 0; i < quads; i++)
+			TransformPoints4(transform, &points[i * 4], &transformed[i * 4]);
+
+		auto t3 = Clock::now();
+		for (uint32_t i = 0; i < quads; i++)
+			TransformPoints4Scalar(transform, &points[i * 4], &transformed[i * 4]);
+
+		auto t4 = Clock::now();
+
+		BSF_INFO("Renderer2D, {0} quads: {1:.2f} ms submit and draw ({2:.1f} ns/quad), transform {3:.2f} ns/quad (scalar: {4:.2f} ns/quad, sink: {5})", quads,
+			Milliseconds(t1 - t0).count(), Milliseconds(t1 - t0).count() * 1e6f / quads,
+			Milliseconds(t3 - t2).count() * 1e6f / quads, Milliseconds(t4 - t3).count() * 1e6f / quads, transformed.back().x);
+	}
+
+	static void BenchmarkRenderer2DFillRate(Application& app)
+	{
+		// Full screen UI layers, an untextured panel and an atlas icon each, drawn with the
+		// single sampler shader and with the 32 samplers one
+		using Clock = std::chrono::steady_clock;
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+
+		constexpr uint32_t layers = 64;
+		constexpr uint32_t runs = 5;
+
+		auto& renderer2d = app.GetRenderer2D();
+		const auto windowSize = app.GetWindowSize();
+		const auto icon = Assets::GetInstance().Get<Texture2D>(AssetName::TexUISphere);
+		const bool singleSamplerPath = renderer2d.GetSingleSamplerPath();
+
+		const auto drawLayers = [&](bool singleSampler) {
+			renderer2d.SetSingleSamplerPath(singleSampler);
+
+			glFinish();
+			auto t0 = Clock::now();
+
+			for (uint32_t r = 0; r < runs; r++)
+			{
+				renderer2d.Begin(glm::ortho(0.0f, windowSize.x, 0.0f, windowSize.y));
+
+				for (uint32_t i = 0; i < layers; i++)
+				{
+					renderer2d.NoTexture();
+					renderer2d.Color({ 0.0f, 0.0f, 0.0f, 0.01f });
+					renderer2d.DrawQuad({ 0.0f, 0.0f }, windowSize);
+					renderer2d.Texture(icon);
+					renderer2d.Color({ 1.0f, 1.0f, 1.0f, 0.01f });
+					renderer2d.DrawQuad({ 0.0f, 0.0f }, windowSize);
+				}
+
+				renderer2d.End();
+			}
+
+			glFinish();
+			return Milliseconds(Clock::now() - t0).count() / runs;
+		};
+
+		const float singleSampler = drawLayers(true);
+		const float switchSampler = drawLayers(false);
+		renderer2d.SetSingleSamplerPath(singleSamplerPath);
+
+		const float pixels = windowSize.x * windowSize.y * layers * 2.0f;
+
+		BSF_INFO("Renderer2D fill rate, {0} full screen quads: single sampler {1:.2f} ms ({2:.0f} Mpix/s), 32 samplers {3:.2f} ms ({4:.0f} Mpix/s)",
+			layers * 2, singleSampler, pixels / singleSampler * 1e-3f, switchSampler, pixels / switchSampler * 1e-3f);
+	}
+
+	struct ScriptedSimulationRun
+	{
+		std::vector<EGameAction> Actions;
+		EGameState State = EGameState::None;
+		glm::vec2 Position = { 0.0f, 0.0f };
+		glm::ivec2 Direction = { 0, 0 };
+		uint32_t Rings = 0, BlueSpheres = 0;
+	};
+
+	static ScriptedSimulationRun RunScriptedSimulation(const Stage& source, ESimulationMode mode, uint32_t tickRate)
+	{
+		// Plays a copy of the stage for a minute with pseudo random input every half second.
+		// Input times are whole ticks, so runs with different tick rates get the same input
+		constexpr uint32_t duration = 60, inputsPerSecond = 2;
+
+		Stage stage = source;
+		GameLogic logic(stage);
+		logic.SetSimulationMode(mode);
+
+		ScriptedSimulationRun result;
+
+		auto unsubscribe = logic.GameStateChanged.Subscribe([&](const GameStateChangedEvent& evt) { result.State = evt.Current; });
+
+		const uint32_t ticksPerInput = tickRate / inputsPerSecond;
+		uint32_t seed = 1;
+
+		for (uint32_t tick = 1; tick <= duration * tickRate; tick++)
+		{
+			if (tick % ticksPerInput == 0)
+			{
+				seed = seed * 1664525u + 1013904223u;
+
+				switch ((seed >> 16) % 5)
+				{
+				case 0: logic.Rotate(GameLogic::ERotate::Left); break;
+				case 1: logic.Rotate(GameLogic::ERotate::Right); break;
+				case 2: logic.Jump(); break;
+				case 3: logic.RunForward(); break;
+				default: break;
+				}
+			}
+
+			logic.Advance({ 1.0f / tickRate, float(tick) / tickRate });
+			logic.GetActions().Drain([&](const GameActionEvent& evt) { result.Actions.push_back(evt.Action); });
+		}
+
+		unsubscribe();
+
+		result.Position = logic.GetPosition();
+		result.Direction = logic.GetDirection();
+		result.Rings = stage.Rings;
+		result.BlueSpheres = stage.Count(EStageObject::BlueSphere);
+
+		return result;
+	}
+
+	struct LateTurnRun
+	{
+		glm::vec2 Position = { 0.0f, 0.0f };
+		glm::ivec2 Direction = { 0, 0 };
+	};
+
+	static std::optional<bool> CheckLateTurn(const Stage& source)
+	{
+		// A turn input that reaches the simulation a few ticks after the edge it was meant for,
+		// but happened before it, must turn at that edge as if it arrived in time. The same input
+		// without its age is a regular late input and must not. Returns nullopt when the stage
+		// has no edge to turn at in the first seconds
+		constexpr uint32_t tickRate = uint32_t(GameSimulation::TickRate), lateTicks = 3;
+		constexpr uint32_t firstTick = 4 * tickRate, lastTick = 20 * tickRate, maxEdges = 16;
+		constexpr float delta = 1.0f / tickRate;
+
+		// Advances the given ticks, then sends the turn
+		auto run = [&](uint32_t ticks, float age) {
+			Stage stage = source;
+			GameLogic logic(stage);
+
+			for (uint32_t tick = 1; tick <= ticks; tick++)
+				logic.Advance({ delta, tick * delta });
+
+			logic.Rotate(GameLogic::ERotate::Left, age);
+			return LateTurnRun{ logic.GetPosition(), logic.GetDirection() };
+		};
+
+		// Ticks in which an edge was crossed on the ground
+		std::vector<uint32_t> edges;
+		{
+			Stage stage = source;
+			GameLogic logic(stage);
+			glm::vec2 position = logic.GetPosition();
+
+			for (uint32_t tick = 1; tick <= lastTick && edges.size() < maxEdges; tick++)
+			{
+				logic.Advance({ delta, tick * delta });
+
+				const glm::vec2 next = logic.GetPosition();
+				if (tick >= firstTick && !logic.IsJumping() && !logic.IsRotating() && glm::floor(next) != glm::floor(position))
+					edges.push_back(tick);
+				position = next;
+			}
+		}
+
+		for (uint32_t edge : edges)
+		{
+			// In time: sent right before the tick that crosses the edge
+			Stage stage = source;
+			GameLogic logic(stage);
+
+			for (uint32_t tick = 1; tick < edge; tick++)
+				logic.Advance({ delta, tick * delta });
+
+			const glm::ivec2 direction = logic.GetDirection();
+			logic.Rotate(GameLogic::ERotate::Left);
+			logic.Advance({ delta, edge * delta });
+
+			// Bumped or just landed, can't turn here
+			if (logic.GetDirection() == direction)
+				continue;
+
+			const auto late = run(edge + lateTicks, (lateTicks + 1) * delta);
+			const auto stale = run(edge + lateTicks, 0.0f);
+
+			return late.Direction == logic.GetDirection() && glm::distance(late.Position, logic.GetPosition()) <= 1e-3f &&
+				stale.Direction == direction;
+		}
+
+		return std::nullopt;
+	}
+
+	static void CheckSimulationModes()
+	{
+		// The event driven simulation must fire the same actions and end in the same state as
+		// the fixed step one (at the GameSimulation tick rate), both at the same and at a lower rate
+		constexpr uint32_t stages = 5;
+		constexpr float positionTolerance = 0.05f;
+
+		auto stageGenerator = Assets::GetInstance().Get<StageGenerator>(AssetName::StageGenerator);
+
+		uint32_t failures = 0;
+
+		for (uint32_t stageNumber = 1; stageNumber <= stages; stageNumber++)
+		{
+			auto stage = stageGenerator->Generate(stageGenerator->GetCodeFromStage(stageNumber));
+
+			if (auto lateTurn = CheckLateTurn(*stage); !lateTurn.has_value())
+				BSF_WARN("Late turn, stage {0}: no edge to turn at", stageNumber);
+			else if (lateTurn.value())
+				BSF_INFO("Late turn, stage {0}: turned at the edge", stageNumber);
+			else
+				BSF_ERROR("Late turn, stage {0}: didn't turn at the edge", stageNumber);
+			const auto reference = RunScriptedSimulation(*stage, ESimulationMode::FixedStep, uint32_t(GameSimulation::TickRate));
+
+			for (uint32_t tickRate : { uint32_t(GameSimulation::TickRate), 60u })
+			{
+				const auto run = RunScriptedSimulation(*stage, ESimulationMode::EventDriven, tickRate);
+
+				const auto mismatch = std::mismatch(reference.Actions.begin(), reference.Actions.end(), run.Actions.begin(), run.Actions.end());
+
+				const bool same = mismatch.first == reference.Actions.end() && mismatch.second == run.Actions.end() &&
+					run.State == reference.State && run.Direction == reference.Direction &&
+					run.Rings == reference.Rings && run.BlueSpheres == reference.BlueSpheres &&
+					glm::distance(run.Position, reference.Position) <= positionTolerance;
+
+				if (same)
+				{
+					BSF_INFO("Simulation modes, stage {0} at {1} Hz: same {2} actions", stageNumber, tickRate, run.Actions.size());
+				}
+				else
+				{
+					failures++;
+					BSF_ERROR("Simulation modes, stage {0} at {1} Hz: diverged at action {2} ({3} and {4} actions), position ({5}, {6}) and ({7}, {8})",
+						stageNumber, tickRate, mismatch.first - reference.Actions.begin(), reference.Actions.size(), run.Actions.size(),
+						reference.Position.x, reference.Position.y, run.Position.x, run.Position.y);
+				}
+			}
+		}
+
+		BSF_INFO("Simulation modes: {0} of {1} runs diverged", failures, stages * 2);
+	}
+
 	struct DiagnosticTool::Impl
 	{
 	public:
 
-		std::unordered_map<const char*, DiagnosticToolStats> Stats;
+		static constexpr size_t s_FrameHistory = 128;
+
+		Impl()
+		{
+			for (auto& frame : m_Frames)
+				ResetFrame(frame);
+			m_Stack.push_back(0);
+		}
+
+		uint32_t BeginScope(const char* name)
+		{
+			if (m_Paused)
+				return DiagnosticScope::None;
+
+			auto& scopes = m_Frames[m_FrameIndex].Scopes;
+			const uint32_t parent = m_Stack.back();
+
+			// Calls from the same parent share the node
+			uint32_t index = scopes[parent].FirstChild;
+			while (index != DiagnosticScope::None && scopes[index].Name != name)
+				index = scopes[index].NextSibling;
+
+			if (index == DiagnosticScope::None)
+			{
+				index = uint32_t(scopes.size());
+
+				DiagnosticScope scope;
+				scope.Name = name;
+				scope.Parent = parent;
+				scope.Depth = scopes[parent].Depth + 1;
+				scopes.push_back(scope);
+
+				auto& parentScope = scopes[parent];
+				if (parentScope.LastChild == DiagnosticScope::None)
+					parentScope.FirstChild = index;
+				else
+					scopes[parentScope.LastChild].NextSibling = index;
+				parentScope.LastChild = index;
+			}
+
+			m_Stack.push_back(index);
+			return index;
+		}
+
+		void EndScope(uint32_t index, float executionTime)
+		{
+			// Scopes opened in a previous frame are dropped
+			if (m_Stack.size() <= 1 || m_Stack.back() != index)
+				return;
+
+			auto& scope = m_Frames[m_FrameIndex].Scopes[index];
+			scope.Calls++;
+			scope.ExecutionTime += executionTime;
+			m_Stack.pop_back();
+		}
 
 		void Initialize(Application* app, GLFWwindow* window)
 		{
@@ -36,15 +425,21 @@ namespace bsf
 
 			ImGui_ImplGlfw_InitForOpenGL(m_Window, true);
 			ImGui_ImplOpenGL3_Init("#version 130");
+
+			GpuProfiler::Get().Initialize();
 		}
 
 		void Begin()
 		{
-			for (auto& item : Stats)
-			{
-				item.second.ExecutionTime = 0.0f;
-				item.second.Calls = 0;
-			}
+			if (!m_Paused)
+				ResetFrame(m_Frames[m_FrameIndex]);
+
+			m_Stack.clear();
+			m_Stack.push_back(0);
+			m_FrameStart = Clock::now();
+
+			GpuProfiler::Get().BeginFrame();
+			GLStats::NextFrame();
 
 			ImGui_ImplOpenGL3_NewFrame();
 			ImGui_ImplGlfw_NewFrame();
@@ -53,23 +448,17 @@ namespace bsf
 
 		void End()
 		{
-			for (auto& item : Stats)
+			if (!m_Paused)
 			{
-				item.second.LastExecutionTimes.pop_back();
-				item.second.LastExecutionTimes.push_front(0.0f);
-			}
+				auto& frame = m_Frames[m_FrameIndex];
+				frame.FrameTime = Milliseconds(Clock::now() - m_FrameStart).count();
+				frame.Scopes[0].ExecutionTime = frame.FrameTime;
+				frame.Scopes[0].Calls = 1;
 
-			for (auto& item : Stats)
-			{
-				auto& execTimes = item.second.LastExecutionTimes;
-				execTimes.front() = item.second.ExecutionTime;
-				item.second.MaxExecutionTime = std::max(item.second.MaxExecutionTime, item.second.ExecutionTime);
-				item.second.MeanExecutionTime = std::accumulate(execTimes.begin(), execTimes.end(), 0.0f) / (float)(DiagnosticToolStats::Samples);
+				m_LastFrame = m_FrameIndex;
+				m_FrameIndex = (m_FrameIndex + 1) % s_FrameHistory;
 			}
 
-
-
-
 			ImGui::Begin("Diagnostic Tool");
 
 
@@ -81,6 +470,35 @@ namespace bsf
 					ImGui::Text("GL Version: %s", glGetString(GL_VERSION));
 					ImGui::Text("GLSL Version: %s", glGetString(GL_SHADING_LANGUAGE_VERSION));
 
+					ImGui::Separator();
+
+					if (ImGui::Button("Reset"))
+						GLStats::Reset();
+
+					ImGui::Columns(3);
+					ImGui::SetColumnWidth(0, 200.0f);
+
+					ImGui::Text("Per frame");
+					ImGui::NextColumn();
+					ImGui::Text("Last");
+					ImGui::NextColumn();
+					ImGui::Text("Max");
+					ImGui::NextColumn();
+
+					ImGui::Separator();
+
+					for (size_t i = 0; i < GLStats::Names.size(); i++)
+					{
+						ImGui::Text(GLStats::Names[i]);
+						ImGui::NextColumn();
+						ImGui::Text("%llu", (unsigned long long)GLStats::LastFrame[i]);
+						ImGui::NextColumn();
+						ImGui::Text("%llu", (unsigned long long)GLStats::MaxFrame[i]);
+						ImGui::NextColumn();
+					}
+
+					ImGui::Columns(1);
+
 					ImGui::EndTabItem();
 				}
 
@@ -89,6 +507,35 @@ namespace bsf
 					if (ImGui::Button("Reset"))
 						Reset();
 
+					ImGui::SameLine();
+					ImGui::Checkbox("Pause", &m_Paused);
+
+					ImGui::SameLine();
+					if (!TraceRecorder::IsEnabled())
+					{
+						if (ImGui::Button("Start Trace"))
+							TraceRecorder::Get().Start(s_TraceFile.data());
+					}
+					else if (ImGui::Button("Stop Trace"))
+					{
+						TraceRecorder::Get().Stop();
+					}
+
+					// Oldest frame first
+					std::array<float, s_FrameHistory> frameTimes;
+					for (size_t i = 0; i < s_FrameHistory; i++)
+						frameTimes[i] = m_Frames[(m_LastFrame + 1 + i) % s_FrameHistory].FrameTime;
+
+					ImGui::PlotHistogram("##FrameTimes", frameTimes.data(), int(s_FrameHistory), 0, nullptr, 0.0f, 33.3f, ImVec2(0.0f, 60.0f));
+					ImGui::SliderInt("Frames ago", &m_SelectedFrame, 0, int(s_FrameHistory) - 1);
+
+					const auto& frame = m_Frames[(m_LastFrame + s_FrameHistory - m_SelectedFrame) % s_FrameHistory];
+					ImGui::Text("Frame time: %.3f ms", frame.FrameTime);
+
+					DrawFlameView(frame);
+
+					ImGui::Separator();
+
 					ImGui::Columns(4);
 					ImGui::SetColumnWidth(0, 400.0f);
 					ImGui::SetColumnWidth(1, 100.0f);
@@ -97,30 +544,111 @@ namespace bsf
 
 					ImGui::Text("Function/Scope");
 					ImGui::NextColumn();
-					ImGui::Text("Avg Time");
+					ImGui::Text("Time");
 					ImGui::NextColumn();
-					ImGui::Text("Max Time");
+					ImGui::Text("Frame %%");
 					ImGui::NextColumn();
 					ImGui::Text("Calls");
 					ImGui::NextColumn();
 
 					ImGui::Separator();
 
-					for (const auto& [name, stats] : DiagnosticTool::Get().m_Impl->Stats)
+					DrawScopeTree(frame, 0);
+
+					ImGui::Columns(1);
+					ImGui::EndTabItem();
+
+				}
+
+				if (ImGui::BeginTabItem("GPU"))
+				{
+					const auto& gpuProfiler = GpuProfiler::Get();
+
+					if (!gpuProfiler.IsSupported())
+					{
+						ImGui::Text("GPU timer queries are not supported");
+					}
+					else
 					{
-						;
-						ImGui::Text(name);
+						ImGui::Columns(3);
+						ImGui::SetColumnWidth(0, 200.0f);
+
+						ImGui::Text("Pass");
 						ImGui::NextColumn();
-						ImGui::Text("%.3f ms", stats.MeanExecutionTime);
+						ImGui::Text("Time");
 						ImGui::NextColumn();
-						ImGui::Text("%.3f ms", stats.MaxExecutionTime);
+						ImGui::Text("Avg Time");
+						ImGui::NextColumn();
+
+						ImGui::Separator();
+
+						float total = 0.0f;
+						for (const auto& scope : gpuProfiler.GetScopes())
+						{
+							ImGui::Text(scope.Name);
+							ImGui::NextColumn();
+							ImGui::Text("%.3f ms", scope.Time);
+							ImGui::NextColumn();
+							ImGui::Text("%.3f ms", scope.MeanTime);
+							ImGui::NextColumn();
+							total += scope.MeanTime;
+						}
+
+						ImGui::Separator();
+						ImGui::Text("Total");
 						ImGui::NextColumn();
-						ImGui::Text("%d", stats.Calls);
 						ImGui::NextColumn();
+						ImGui::Text("%.3f ms", total);
+						ImGui::NextColumn();
+
+						ImGui::Columns(1);
 					}
 
 					ImGui::EndTabItem();
+				}
+
+				if (ImGui::BeginTabItem("Frames"))
+				{
+					auto& frameTimes = m_App->GetFrameTimes();
+
+					if (ImGui::Button("Reset"))
+						frameTimes.Reset();
+
+					ImGui::Columns(6);
+					ImGui::SetColumnWidth(0, 200.0f);
+
+					for (const char* header : { "Scene", "Frames", "p50", "p95", "p99", "Max" })
+					{
+						ImGui::Text(header);
+						ImGui::NextColumn();
+					}
 
+					ImGui::Separator();
+
+					for (const auto& stats : frameTimes.GetSceneStats())
+					{
+						auto row = [&](const char* label, const FrameTimeHistogram& h) {
+							ImGui::Text("%s %s", stats.Name.c_str(), label);
+							ImGui::NextColumn();
+							ImGui::Text("%llu", (unsigned long long)h.GetCount());
+							ImGui::NextColumn();
+							for (float p : { 50.0f, 95.0f, 99.0f })
+							{
+								ImGui::Text("%.2f ms", h.GetPercentile(p));
+								ImGui::NextColumn();
+							}
+							ImGui::Text("%.2f ms", h.GetMax());
+							ImGui::NextColumn();
+						};
+
+						row("(frame)", stats.Total);
+						row("(CPU)", stats.Cpu);
+						row("(swap)", stats.Swap);
+						ImGui::Separator();
+					}
+
+					ImGui::Columns(1);
+					ImGui::EndTabItem();
 				}
 
 				if (ImGui::BeginTabItem("Utility"))
@@ -146,6 +674,18 @@ namespace bsf
 							s.Save(file);
 						}
 					}
+
+					if (ImGui::Button("Benchmark EventEmitter"))
+						BenchmarkEventEmitter();
+
+					if (ImGui::Button("Benchmark Renderer2D"))
+						BenchmarkRenderer2D(*m_App);
+
+					if (ImGui::Button("Benchmark Renderer2D Fill Rate"))
+						BenchmarkRenderer2DFillRate(*m_App);
+
+					if (ImGui::Button("Check Simulation Modes"))
+						CheckSimulationModes();
 					
 					ImGui::EndTabItem();
 				}
@@ -174,11 +714,119 @@ namespace bsf
 			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 		}
 	
-		void Reset() { Stats.clear(); }
+		void Reset()
+		{
+			for (auto& frame : m_Frames)
+				ResetFrame(frame);
+		}
 
 	private:
+		using Clock = std::chrono::steady_clock;
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+
+		static void ResetFrame(DiagnosticFrame& frame)
+		{
+			frame.Scopes.clear();
+			frame.Scopes.emplace_back().Name = "Frame";
+			frame.FrameTime = 0.0f;
+		}
+
+		void DrawFlameView(const DiagnosticFrame& frame)
+		{
+			constexpr float rowHeight = 18.0f;
+
+			const auto& scopes = frame.Scopes;
+			uint32_t maxDepth = 0;
+			for (const auto& scope : scopes)
+				maxDepth = std::max(maxDepth, scope.Depth);
+
+			const ImVec2 origin = ImGui::GetCursorScreenPos();
+			const float width = ImGui::GetContentRegionAvail().x;
+			ImGui::Dummy(ImVec2(width, rowHeight * (maxDepth + 1)));
+
+			if (frame.FrameTime <= 0.0f)
+				return;
+
+			// Children start where their parent starts and are laid out in call order.
+			// Children are always stored after their parent
+			m_FlameOffsets.assign(scopes.size(), 0.0f);
+			for (uint32_t i = 0; i < scopes.size(); i++)
+			{
+				float offset = m_FlameOffsets[i];
+				for (uint32_t child = scopes[i].FirstChild; child != DiagnosticScope::None; child = scopes[child].NextSibling)
+				{
+					m_FlameOffsets[child] = offset;
+					offset += scopes[child].ExecutionTime;
+				}
+			}
+
+			auto drawList = ImGui::GetWindowDrawList();
+			const float scale = width / frame.FrameTime;
+
+			for (uint32_t i = 0; i < scopes.size(); i++)
+			{
+				const auto& scope = scopes[i];
+
+				ImVec2 min = { origin.x + m_FlameOffsets[i] * scale, origin.y + scope.Depth * rowHeight };
+				ImVec2 max = { min.x + std::max(1.0f, scope.ExecutionTime * scale), min.y + rowHeight - 1.0f };
+
+				// Stable color per scope name
+				const size_t hash = std::hash<const void*>()(scope.Name);
+				const ImU32 color = IM_COL32(128 + (hash & 0x7f), 96 + ((hash >> 7) & 0x3f), 64 + ((hash >> 13) & 0x3f), 255);
+
+				drawList->AddRectFilled(min, max, color);
+
+				if (max.x - min.x > 24.0f)
+				{
+					drawList->PushClipRect(min, max, true);
+					drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), scope.Name);
+					drawList->PopClipRect();
+				}
+
+				if (ImGui::IsMouseHoveringRect(min, max))
+					ImGui::SetTooltip("%s\n%.3f ms, %u calls", scope.Name, scope.ExecutionTime, scope.Calls);
+			}
+		}
+
+		void DrawScopeTree(const DiagnosticFrame& frame, uint32_t index)
+		{
+			const auto& scope = frame.Scopes[index];
+
+			ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_DefaultOpen;
+			if (scope.FirstChild == DiagnosticScope::None)
+				flags |= ImGuiTreeNodeFlags_Leaf;
+
+			ImGui::PushID(int(index));
+			bool open = ImGui::TreeNodeEx(scope.Name, flags);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f ms", scope.ExecutionTime);
+			ImGui::NextColumn();
+			ImGui::Text("%.1f", frame.FrameTime > 0.0f ? 100.0f * scope.ExecutionTime / frame.FrameTime : 0.0f);
+			ImGui::NextColumn();
+			ImGui::Text("%u", scope.Calls);
+			ImGui::NextColumn();
+			ImGui::PopID();
+
+			if (open)
+			{
+				for (uint32_t child = scope.FirstChild; child != DiagnosticScope::None; child = frame.Scopes[child].NextSibling)
+					DrawScopeTree(frame, child);
+				ImGui::TreePop();
+			}
+		}
+
 		Application* m_App = nullptr;
 		GLFWwindow* m_Window = nullptr;
+
+		// Ring buffer of recorded frames
+		std::array<DiagnosticFrame, s_FrameHistory> m_Frames;
+		size_t m_FrameIndex = 0, m_LastFrame = 0;
+		std::vector<uint32_t> m_Stack;
+		Clock::time_point m_FrameStart;
+		bool m_Paused = false;
+		int32_t m_SelectedFrame = 0;
+		std::vector<float> m_FlameOffsets;
+
 		char m_StageNumber[0xff];
 	};
 
@@ -216,18 +864,17 @@ namespace bsf
 
 
 
-	DiagnosticGuard::DiagnosticGuard(const char* name) : m_Name(name)
+	DiagnosticGuard::DiagnosticGuard(const char* name)
 	{
+		m_Scope = DiagnosticTool::Get().m_Impl->BeginScope(name);
 		m_t0 = Clock::now();
 	}
 
 	DiagnosticGuard::~DiagnosticGuard()
 	{
-		auto& stats = DiagnosticTool::Get().m_Impl->Stats[m_Name];
 		auto t1 = Clock::now();
-		stats.Calls++;
-		stats.ExecutionTime += 
-			std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(t1 - m_t0).count();
+		DiagnosticTool::Get().m_Impl->EndScope(m_Scope,
+			std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(t1 - m_t0).count());
 	}
 }
 
@@ -1,41 +1,67 @@
 #pragma once
 
 
-#include <string>
-#include <map>
-#include <list>
 #include <chrono>
-#include <unordered_map>
+#include <limits>
+#include <memory>
+#include <vector>
 
 #include <GLFW/glfw3.h>
 
+#include "Trace.h"
+#include "FrameStats.h"
+#include "GpuProfiler.h"
+
+#define BSF_DIAGNOSTIC_CONCAT_IMPL(a, b) a##b
+#define BSF_DIAGNOSTIC_CONCAT(a, b) BSF_DIAGNOSTIC_CONCAT_IMPL(a, b)
+
+// Scopes are always traced (see TraceRecorder), the profiler UI is compiled out in Distribution
+#define BSF_TRACE_SCOPE(name) TraceGuard BSF_DIAGNOSTIC_CONCAT(bsf_tguard, __LINE__) (name)
+
+#ifdef BSF_DISTRIBUTION
+#define BSF_FRAME_STATS_SCOPE(name) static const uint32_t BSF_DIAGNOSTIC_CONCAT(bsf_sid, __LINE__) = FrameStats::RegisterScope(name); \
+	FrameStatsGuard BSF_DIAGNOSTIC_CONCAT(bsf_sguard, __LINE__) (BSF_DIAGNOSTIC_CONCAT(bsf_sid, __LINE__))
+#define BSF_FRAME_STATS_END_FRAME() FrameStats::Get().EndFrame()
+#else
+#define BSF_FRAME_STATS_SCOPE(name)
+#define BSF_FRAME_STATS_END_FRAME()
+#endif
+
 #ifdef BSF_ENABLE_DIAGNOSTIC
 #define BSF_DIAGNOSTIC_INIT(app, window) DiagnosticTool::Get().Initialize(app, window)
 #define BSF_DIAGNOSTIC_BEGIN() DiagnosticTool::Get().Begin()
-#define BSF_DIAGNOSTIC_FUNC() DiagnosticGuard bsf_dguard##__LINE__ (__FUNCTION__)
-#define BSF_DIAGNOSTIC_SCOPE(name) DiagnosticGuard bsf_dguard##__LINE__ (name)
+#define BSF_DIAGNOSTIC_FUNC() BSF_TRACE_SCOPE(__FUNCTION__); DiagnosticGuard BSF_DIAGNOSTIC_CONCAT(bsf_dguard, __LINE__) (__FUNCTION__)
+#define BSF_DIAGNOSTIC_SCOPE(name) BSF_TRACE_SCOPE(name); DiagnosticGuard BSF_DIAGNOSTIC_CONCAT(bsf_dguard, __LINE__) (name)
+#define BSF_DIAGNOSTIC_GPU_SCOPE(name) GpuProfilerGuard BSF_DIAGNOSTIC_CONCAT(bsf_gguard, __LINE__) (name)
 #define BSF_DIAGNOSTIC_END() DiagnosticTool::Get().End()
 #else
 #define BSF_DIAGNOSTIC_INIT(app, window)
 #define BSF_DIAGNOSTIC_BEGIN()
-#define BSF_DIAGNOSTIC_FUNC()
-#define BSF_DIAGNOSTIC_SCOPE(name)
-#define BSF_DIAGNOSTIC_END()
+#define BSF_DIAGNOSTIC_FUNC() BSF_TRACE_SCOPE(__FUNCTION__); BSF_FRAME_STATS_SCOPE(__FUNCTION__)
+#define BSF_DIAGNOSTIC_SCOPE(name) BSF_TRACE_SCOPE(name); BSF_FRAME_STATS_SCOPE(name)
+#define BSF_DIAGNOSTIC_GPU_SCOPE(name)
+#define BSF_DIAGNOSTIC_END() BSF_FRAME_STATS_END_FRAME()
 #define BSF_DIAGNOSTIC_RESET()
 #endif
 namespace bsf
 {
 	class Application;
 
-	struct DiagnosticToolStats
+	// Node of the per-frame call tree, calls of the same scope from the same parent are merged
+	struct DiagnosticScope
 	{
-		static constexpr size_t Samples = 10;
-		const char* StackItemName = nullptr;
+		static constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+		const char* Name = nullptr;
+		uint32_t Parent = None, FirstChild = None, LastChild = None, NextSibling = None;
+		uint32_t Depth = 0;
 		uint32_t Calls = 0;
 		float ExecutionTime = 0.0f;
-		float MeanExecutionTime = 0.0f;
-		float MaxExecutionTime = 0.0f;
-		std::list<float> LastExecutionTimes = std::list<float>(Samples);
+	};
+
+	struct DiagnosticFrame
+	{
+		std::vector<DiagnosticScope> Scopes;
+		float FrameTime = 0.0f;
 	};
 
 	struct DiagnosticGuard
@@ -44,9 +70,9 @@ namespace bsf
 		DiagnosticGuard(const char* name);
 		~DiagnosticGuard();
 	private:
-		using Clock = std::chrono::system_clock;
+		using Clock = std::chrono::steady_clock;
 		Clock::time_point m_t0;
-		const char* m_Name;
+		uint32_t m_Scope;
 	};
 
 	class DiagnosticTool
@@ -31,13 +31,13 @@ namespace bsf
 	void DisclaimerScene::OnAttach()
 	{
 		
-		auto fadeIn = ScheduleTask<FadeTask>(ESceneTaskEvent::PostRender,
+		ScheduleTask<FadeTask>(ESceneTaskEvent::PostRender,
 			glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 0.0f), 0.5f);
 
-		auto waitFadeOut = MakeRef<WaitForTask>(5.0f);
+		auto waitFadeOut = CreateTask<WaitForTask>(5.0f);
 
 		waitFadeOut->SetDoneFunction([&](SceneTask& self) {
-			auto fadeOut = MakeRef<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 0.5f);
+			auto fadeOut = CreateTask<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 0.5f);
 			fadeOut->SetDoneFunction([&](SceneTask& self) {
 				GetApplication().GotoScene(MakeRef<SplashScene>());
 			});
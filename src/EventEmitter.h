@@ -1,7 +1,11 @@
 #pragma once
 
-#include <functional>
-#include <list>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include "InplaceFunction.h"
 #include "Log.h"
 
 
@@ -11,10 +15,11 @@
 // clear the subscriptions when a scene change starts
 namespace bsf
 {
-	using Unsubscribe = std::function<void()>;
-
 	#pragma region Events
 
+	// When the input was received, see InputQueue
+	using InputTimestamp = std::chrono::steady_clock::time_point;
+
 	enum class Direction
 	{
 		Left, Right, Up, Down
@@ -29,6 +34,7 @@ namespace bsf
 	{
 		float X, Y, DeltaX, DeltaY;
 		MouseButton Button;
+		InputTimestamp Timestamp = {};
 	};
 
 	struct WheelEvent
@@ -46,11 +52,13 @@ namespace bsf
 	{
 		int32_t KeyCode;
 		bool Repeat;
+		InputTimestamp Timestamp = {};
 	};
 
 	struct KeyReleasedEvent
 	{
 		int32_t KeyCode;
+		InputTimestamp Timestamp = {};
 	};
 
 	struct CharacterTypedEvent
@@ -60,12 +68,32 @@ namespace bsf
 
 	#pragma endregion
 
+	// Handle returned by EventEmitter::Subscribe. It's generation checked, so
+	// unsubscribing twice (or after the slot has been reused) does nothing
+	struct Subscription
+	{
+		using UnsubscribeFnPtr = void(*)(void*, uint32_t, uint32_t);
+
+		void* Emitter = nullptr;
+		UnsubscribeFnPtr UnsubscribeFn = nullptr;
+		uint32_t Slot = 0, Generation = 0;
+
+		void operator()()
+		{
+			if (UnsubscribeFn != nullptr)
+				UnsubscribeFn(Emitter, Slot, Generation);
+			UnsubscribeFn = nullptr;
+		}
+	};
+
+	using Unsubscribe = Subscription;
+
 	template<typename Event>
 	class EventEmitter
 	{
 	public:
 
-		using HandlerFn = std::function<void(const Event&)>;
+		using HandlerFn = InplaceFunction<void(const Event&)>;
 
 		using HandlerFnPtr = void(*)(const Event&);
 
@@ -85,24 +113,119 @@ namespace bsf
 
 		Unsubscribe Subscribe(const HandlerFn& handler)
 		{
-			auto handlerIt = m_Handlers.insert(m_Handlers.end(), handler);
-			return [&, handlerIt] { m_Handlers.erase(handlerIt); };
+			return Subscribe(HandlerFn(handler));
 		}
 
 		Unsubscribe Subscribe(HandlerFn&& handler)
 		{
-			auto handlerIt = m_Handlers.insert(m_Handlers.end(), std::move(handler));
-			return [&, handlerIt] { m_Handlers.erase(handlerIt); };
+			uint32_t slot;
+
+			if (m_FreeSlots.empty())
+			{
+				slot = (uint32_t)m_Slots.size();
+				m_Slots.emplace_back();
+			}
+			else
+			{
+				slot = m_FreeSlots.back();
+				m_FreeSlots.pop_back();
+			}
+
+			// While emitting, the handlers vector must not be reallocated (a handler is running
+			// from it), so new handlers are parked until the emit is done
+			auto& target = m_EmitDepth > 0 ? m_PendingHandlers : m_Handlers;
+			m_Slots[slot].HandlerIndex = uint32_t(m_Handlers.size() + m_PendingHandlers.size());
+			target.push_back({ std::move(handler), slot });
+
+			return { this, &EventEmitter::UnsubscribeThunk, slot, m_Slots[slot].Generation };
+		}
+
+		bool HasSubscribers() const
+		{
+			return m_Handlers.size() + m_PendingHandlers.size() > m_DeadHandlers;
 		}
 
 		void Emit(const Event& evt)
 		{
-			for (auto& handler : m_Handlers)
-				handler(evt);
+			++m_EmitDepth;
+
+			const size_t count = m_Handlers.size();
+			for (size_t i = 0; i < count; i++)
+			{
+				if (m_Handlers[i].Slot != s_InvalidSlot)
+					m_Handlers[i].Fn(evt);
+			}
+
+			if (--m_EmitDepth == 0 && (m_DeadHandlers > 0 || !m_PendingHandlers.empty()))
+				Compact();
+		}
+
+	private:
+
+		static constexpr uint32_t s_InvalidSlot = std::numeric_limits<uint32_t>::max();
+
+		struct Handler
+		{
+			HandlerFn Fn;
+			uint32_t Slot;
+		};
+
+		struct HandlerSlot
+		{
+			uint32_t HandlerIndex = 0;
+			uint32_t Generation = 0;
+		};
+
+		std::vector<Handler> m_Handlers, m_PendingHandlers;
+		std::vector<HandlerSlot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+		uint32_t m_DeadHandlers = 0;
+		uint32_t m_EmitDepth = 0;
+
+		static void UnsubscribeThunk(void* emitter, uint32_t slot, uint32_t generation)
+		{
+			static_cast<EventEmitter*>(emitter)->RemoveHandler(slot, generation);
+		}
+
+		void RemoveHandler(uint32_t slot, uint32_t generation)
+		{
+			if (slot >= m_Slots.size() || m_Slots[slot].Generation != generation)
+				return;
+
+			const uint32_t index = m_Slots[slot].HandlerIndex;
+
+			// The handler itself is only marked as dead: it might be the one that is running
+			if (index < m_Handlers.size())
+				m_Handlers[index].Slot = s_InvalidSlot;
+			else
+				m_PendingHandlers[index - m_Handlers.size()].Slot = s_InvalidSlot;
+
+			m_DeadHandlers++;
+			m_Slots[slot].Generation++;
+			m_FreeSlots.push_back(slot);
+
+			if (m_EmitDepth == 0)
+				Compact();
+		}
+
+		void Compact()
+		{
+			m_Handlers.erase(std::remove_if(m_Handlers.begin(), m_Handlers.end(),
+				[](const Handler& h) { return h.Slot == s_InvalidSlot; }), m_Handlers.end());
+
+			for (auto& h : m_PendingHandlers)
+			{
+				if (h.Slot != s_InvalidSlot)
+					m_Handlers.push_back(std::move(h));
+			}
+
+			m_PendingHandlers.clear();
+			m_DeadHandlers = 0;
+
+			for (uint32_t i = 0; i < m_Handlers.size(); i++)
+				m_Slots[m_Handlers[i].Slot].HandlerIndex = i;
 		}
 
-	protected:
-		std::list<HandlerFn> m_Handlers;
 	};
 
 	class EventReceiver
@@ -136,7 +259,7 @@ namespace bsf
 
 
 	private:
-		std::list<Unsubscribe> m_Subscriptions;
+		std::vector<Unsubscribe> m_Subscriptions;
 
 	};
 
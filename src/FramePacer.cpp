@@ -0,0 +1,53 @@
+#include "BsfPch.h"
+
+#include <thread>
+
+#include "FramePacer.h"
+
+namespace bsf
+{
+	void FramePacer::SetTargetFrameRate(float fps)
+	{
+		if (fps == m_TargetFrameRate)
+			return;
+
+		m_TargetFrameRate = fps;
+		m_FramePeriod = fps > 0.0f ?
+			std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0f / fps)) :
+			Clock::duration::zero();
+		m_NextFrame = Clock::now() + m_FramePeriod;
+	}
+
+	void FramePacer::Wait()
+	{
+		auto now = Clock::now();
+
+		if (m_FramePeriod == Clock::duration::zero())
+		{
+			m_NextFrame = now;
+			return;
+		}
+
+		// Don't try to catch up after a long frame
+		if (now - m_NextFrame > m_FramePeriod)
+			m_NextFrame = now;
+
+		// Sleep in small steps while there's enough margin
+		while (Milliseconds(m_NextFrame - now).count() > m_SleepOvershoot + 1.0f)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			const auto t = Clock::now();
+			const float overshoot = Milliseconds(t - now).count() - 1.0f;
+
+			// Follow increases immediately, decreases slowly
+			m_SleepOvershoot = std::max(overshoot, glm::mix(m_SleepOvershoot, overshoot, 0.05f));
+			now = t;
+		}
+
+		while (Clock::now() < m_NextFrame)
+			std::this_thread::yield();
+
+		m_NextFrame += m_FramePeriod;
+	}
+}
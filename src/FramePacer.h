@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+
+namespace bsf
+{
+	// Limits the frame rate. Most of the wait is spent sleeping, the last part spins on the
+	// clock since sleep can overshoot by more than a millisecond (15 ms on some systems).
+	// The expected overshoot is measured while sleeping
+	class FramePacer
+	{
+	public:
+		// 0 means unlimited
+		void SetTargetFrameRate(float fps);
+		float GetTargetFrameRate() const { return m_TargetFrameRate; }
+
+		// Waits until the next frame is due, call once per frame
+		void Wait();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+
+		float m_TargetFrameRate = 0.0f;
+		Clock::duration m_FramePeriod = Clock::duration::zero();
+		Clock::time_point m_NextFrame = Clock::now();
+		float m_SleepOvershoot = 1.0f; // Milliseconds
+	};
+}
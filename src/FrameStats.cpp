@@ -0,0 +1,92 @@
+#include "BsfPch.h"
+
+#include "FrameStats.h"
+#include "Log.h"
+
+namespace bsf
+{
+	FrameStats& FrameStats::Get()
+	{
+		static FrameStats instance;
+		return instance;
+	}
+
+	FrameStats::FrameStats()
+	{
+		// Last slot collects scopes registered after the table is full
+		m_Scopes.back().Name = "Other";
+
+		m_PeriodStart = m_LastFrame = Clock::now();
+		m_PeriodStartTicks = Now();
+	}
+
+	uint32_t FrameStats::RegisterScope(const char* name)
+	{
+		auto& stats = Get();
+
+		if (stats.m_ScopeCount == s_MaxScopes - 1)
+			return s_MaxScopes - 1;
+
+		stats.m_Scopes[stats.m_ScopeCount].Name = name;
+		return stats.m_ScopeCount++;
+	}
+
+	void FrameStats::EndFrame()
+	{
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+
+		const auto now = Clock::now();
+		const float frameTime = Milliseconds(now - m_LastFrame).count();
+		m_LastFrame = now;
+
+		m_FrameTimes.Record(frameTime);
+
+		const float periodTime = Milliseconds(now - m_PeriodStart).count();
+		if (periodTime >= s_SummaryPeriod * 1000.0f)
+		{
+			WriteSummary(periodTime);
+
+			for (auto& scope : m_Scopes)
+				scope.Calls = scope.Ticks = 0;
+
+			m_FrameTimes.Reset();
+			m_PeriodStart = now;
+			m_PeriodStartTicks = Now();
+		}
+	}
+
+	void FrameStats::WriteSummary(float periodTime)
+	{
+		if (m_FrameTimes.GetCount() == 0)
+			return;
+
+		const float frames = float(m_FrameTimes.GetCount());
+
+		BSF_INFO("Frame stats ({0:.0f} s, {1} frames): avg {2:.2f} ms, p50 {3:.2f} ms, p95 {4:.2f} ms, p99 {5:.2f} ms, max {6:.2f} ms",
+			periodTime / 1000.0f, m_FrameTimes.GetCount(), m_FrameTimes.GetMean(), m_FrameTimes.GetPercentile(50.0f),
+			m_FrameTimes.GetPercentile(95.0f), m_FrameTimes.GetPercentile(99.0f), m_FrameTimes.GetMax());
+
+		// Calibrate ticks with the steady clock over the whole period
+		const double ticksPerMs = double(Now() - m_PeriodStartTicks) / periodTime;
+		if (ticksPerMs <= 0.0)
+			return;
+
+		std::array<uint32_t, s_MaxScopes> order;
+		std::iota(order.begin(), order.end(), 0);
+
+		const uint32_t count = std::min(s_TopScopes, s_MaxScopes);
+		std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](uint32_t a, uint32_t b) {
+			return m_Scopes[a].Ticks > m_Scopes[b].Ticks;
+		});
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const auto& scope = m_Scopes[order[i]];
+			if (scope.Calls == 0)
+				break;
+
+			BSF_INFO("  {0}: {1:.3f} ms/frame, {2:.1f} calls/frame", scope.Name,
+				scope.Ticks / ticksPerMs / frames, scope.Calls / frames);
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "FrameTiming.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BSF_FRAME_STATS_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BSF_FRAME_STATS_RDTSC
+#endif
+
+namespace bsf
+{
+	// Always-on frame statistics for Distribution builds. Scopes get an id once per call site
+	// and only add to a fixed counters table, every few seconds a summary with frame time
+	// percentiles and the most expensive scopes is written to the log.
+	// Scopes must run on the main thread
+	class FrameStats
+	{
+	public:
+		static constexpr uint32_t s_MaxScopes = 128;
+		static constexpr float s_SummaryPeriod = 30.0f; // Seconds
+		static constexpr uint32_t s_TopScopes = 5;
+
+		static FrameStats& Get();
+
+		static uint32_t RegisterScope(const char* name);
+
+		static uint64_t Now()
+		{
+#ifdef BSF_FRAME_STATS_RDTSC
+			return __rdtsc();
+#else
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+#endif
+		}
+
+		void AddScope(uint32_t id, uint64_t ticks)
+		{
+			auto& scope = m_Scopes[id];
+			scope.Calls++;
+			scope.Ticks += ticks;
+		}
+
+		void EndFrame();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct ScopeCounters
+		{
+			const char* Name = nullptr;
+			uint64_t Calls = 0;
+			uint64_t Ticks = 0;
+		};
+
+		FrameStats();
+
+		void WriteSummary(float periodTime);
+
+		std::array<ScopeCounters, s_MaxScopes> m_Scopes;
+		uint32_t m_ScopeCount = 0;
+
+		FrameTimeHistogram m_FrameTimes;
+
+		Clock::time_point m_PeriodStart, m_LastFrame;
+		uint64_t m_PeriodStartTicks = 0;
+	};
+
+	struct FrameStatsGuard
+	{
+	public:
+		FrameStatsGuard(uint32_t id) : m_Id(id), m_t0(FrameStats::Now()) {}
+		~FrameStatsGuard() { FrameStats::Get().AddScope(m_Id, FrameStats::Now() - m_t0); }
+	private:
+		uint32_t m_Id;
+		uint64_t m_t0;
+	};
+}
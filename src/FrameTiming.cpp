@@ -0,0 +1,157 @@
+#include "BsfPch.h"
+
+#include "FrameTiming.h"
+#include "Log.h"
+
+#ifndef _MSC_VER
+#include <cxxabi.h>
+#endif
+
+namespace bsf
+{
+	namespace
+	{
+		// Class name without namespaces, type_info names are mangled on GCC and Clang
+		std::string GetTypeName(std::type_index type)
+		{
+			std::string name = type.name();
+
+#ifndef _MSC_VER
+			int status = 0;
+			if (char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status); status == 0)
+			{
+				name = demangled;
+				std::free(demangled);
+			}
+#endif
+
+			if (auto pos = name.rfind(':'); pos != std::string::npos)
+				name = name.substr(pos + 1);
+
+			return name;
+		}
+	}
+
+#pragma region FrameTimeHistogram
+
+	uint32_t FrameTimeHistogram::GetBucket(uint32_t value)
+	{
+		if (value < s_SubBuckets)
+			return value;
+
+		// Keep the top 5 bits, the position of the highest bit selects the range
+		uint32_t shift = 0;
+		while ((value >> shift) >= s_SubBuckets)
+			++shift;
+
+		return s_SubBuckets + (shift - 1) * s_HalfSubBuckets + ((value >> shift) - s_HalfSubBuckets);
+	}
+
+	uint32_t FrameTimeHistogram::GetBucketUpperBound(uint32_t bucket)
+	{
+		if (bucket < s_SubBuckets)
+			return bucket;
+
+		const uint32_t shift = (bucket - s_SubBuckets) / s_HalfSubBuckets + 1;
+		const uint32_t subBucket = (bucket - s_SubBuckets) % s_HalfSubBuckets + s_HalfSubBuckets;
+		return ((subBucket + 1) << shift) - 1;
+	}
+
+	void FrameTimeHistogram::Record(float milliseconds)
+	{
+		const uint32_t value = uint32_t(std::clamp(milliseconds * 1000.0f, 0.0f, float(s_MaxValue)));
+
+		m_Buckets[GetBucket(value)]++;
+		m_Count++;
+		m_Total += value;
+		m_Max = std::max(m_Max, value);
+	}
+
+	void FrameTimeHistogram::Reset()
+	{
+		m_Buckets.fill(0);
+		m_Count = m_Total = 0;
+		m_Max = 0;
+	}
+
+	float FrameTimeHistogram::GetPercentile(float percentile) const
+	{
+		if (m_Count == 0)
+			return 0.0f;
+
+		const uint64_t target = std::max<uint64_t>(1, uint64_t(std::ceil(percentile / 100.0f * m_Count)));
+		uint64_t count = 0;
+
+		for (uint32_t i = 0; i < s_BucketCount; i++)
+		{
+			count += m_Buckets[i];
+			if (count >= target)
+				return std::min(GetBucketUpperBound(i), m_Max) / 1000.0f;
+		}
+
+		return GetMax();
+	}
+
+	float FrameTimeHistogram::GetMean() const
+	{
+		return m_Count > 0 ? float(double(m_Total) / m_Count / 1000.0) : 0.0f;
+	}
+
+#pragma endregion
+
+#pragma region FrameTimeTracker
+
+	void FrameTimeTracker::Record(std::type_index sceneType, float cpu, float swap, float total)
+	{
+		// Same scene of the previous frame almost always
+		if (m_LastScene >= m_Scenes.size() || m_Scenes[m_LastScene].Type != sceneType)
+		{
+			auto it = std::find_if(m_Scenes.begin(), m_Scenes.end(), [&](const SceneStats& s) { return s.Type == sceneType; });
+
+			if (it == m_Scenes.end())
+			{
+				m_Scenes.push_back({ sceneType, GetTypeName(sceneType), {}, {}, {} });
+				it = m_Scenes.end() - 1;
+			}
+
+			m_LastScene = std::distance(m_Scenes.begin(), it);
+		}
+
+		auto& stats = m_Scenes[m_LastScene];
+		stats.Cpu.Record(cpu);
+		stats.Swap.Record(swap);
+		stats.Total.Record(total);
+	}
+
+	void FrameTimeTracker::Reset()
+	{
+		for (auto& stats : m_Scenes)
+		{
+			stats.Total.Reset();
+			stats.Cpu.Reset();
+			stats.Swap.Reset();
+		}
+	}
+
+	void FrameTimeTracker::WriteReport() const
+	{
+		for (const auto& stats : m_Scenes)
+		{
+			if (stats.Total.GetCount() == 0)
+				continue;
+
+			BSF_INFO("{0}: {1} frames", stats.Name, stats.Total.GetCount());
+
+			auto writeLine = [](const char* label, const FrameTimeHistogram& h) {
+				BSF_INFO("  {0:<5} p50 {1:.2f} ms, p95 {2:.2f} ms, p99 {3:.2f} ms, max {4:.2f} ms",
+					label, h.GetPercentile(50.0f), h.GetPercentile(95.0f), h.GetPercentile(99.0f), h.GetMax());
+			};
+
+			writeLine("Frame", stats.Total);
+			writeLine("CPU", stats.Cpu);
+			writeLine("Swap", stats.Swap);
+		}
+	}
+
+#pragma endregion
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+namespace bsf
+{
+	// HDR style histogram of durations with microsecond resolution, from 1 us to about 67 s.
+	// Buckets are linear within each power of two range, so values are within ~6% of the real
+	// ones while the histogram has a small fixed size
+	class FrameTimeHistogram
+	{
+	public:
+		void Record(float milliseconds);
+		void Reset();
+
+		float GetPercentile(float percentile) const;
+		float GetMean() const;
+		float GetMax() const { return m_Max / 1000.0f; }
+		uint64_t GetCount() const { return m_Count; }
+
+	private:
+		static constexpr uint32_t s_SubBuckets = 32;
+		static constexpr uint32_t s_HalfSubBuckets = s_SubBuckets / 2;
+		static constexpr uint32_t s_MaxValue = (1u << 26) - 1;
+		static constexpr uint32_t s_BucketCount = s_SubBuckets + 21 * s_HalfSubBuckets;
+
+		static uint32_t GetBucket(uint32_t value);
+		static uint32_t GetBucketUpperBound(uint32_t bucket);
+
+		std::array<uint32_t, s_BucketCount> m_Buckets = {};
+		uint64_t m_Count = 0;
+		uint64_t m_Total = 0;
+		uint32_t m_Max = 0;
+	};
+
+	// Frame times of each scene type, split between the CPU work of the frame and the time spent
+	// waiting in glfwSwapBuffers
+	class FrameTimeTracker
+	{
+	public:
+		struct SceneStats
+		{
+			std::type_index Type;
+			std::string Name;
+			FrameTimeHistogram Total, Cpu, Swap;
+		};
+
+		template<typename T>
+		void Record(const T& scene, float cpu, float swap, float total) { Record(std::type_index(typeid(scene)), cpu, swap, total); }
+		void Record(std::type_index sceneType, float cpu, float swap, float total);
+
+		const std::vector<SceneStats>& GetSceneStats() const { return m_Scenes; }
+
+		void Reset();
+		void WriteReport() const;
+
+	private:
+		std::vector<SceneStats> m_Scenes;
+		size_t m_LastScene = 0;
+	};
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#ifdef BSF_ENABLE_DIAGNOSTIC
+#define BSF_GLSTAT(counter) ::bsf::GLStats::Add(::bsf::EGLCounter::counter, 1)
+#define BSF_GLSTAT_ADD(counter, n) ::bsf::GLStats::Add(::bsf::EGLCounter::counter, n)
+#else
+#define BSF_GLSTAT(counter)
+#define BSF_GLSTAT_ADD(counter, n)
+#endif
+
+namespace bsf
+{
+	enum class EGLCounter : uint32_t
+	{
+		DrawCalls,
+		ProgramSwitches,
+		TextureBinds,
+		UniformUploads,
+		BufferUploads,
+		BufferUploadBytes,
+		GLCalls,
+		Count
+	};
+
+	// Per-frame OpenGL call counters, only updated when diagnostics are enabled
+	struct GLStats
+	{
+		using Counters = std::array<uint64_t, size_t(EGLCounter::Count)>;
+
+		static constexpr std::array<const char*, size_t(EGLCounter::Count)> Names = {
+			"Draw calls",
+			"Program switches",
+			"Texture binds",
+			"Uniform uploads",
+			"Buffer uploads",
+			"Buffer upload bytes",
+			"GL calls"
+		};
+
+		inline static Counters Current = {};
+		inline static Counters LastFrame = {};
+		inline static Counters MaxFrame = {};
+
+		static void Add(EGLCounter counter, uint64_t n) { Current[size_t(counter)] += n; }
+
+		static void NextFrame()
+		{
+			LastFrame = Current;
+			for (size_t i = 0; i < Current.size(); i++)
+				MaxFrame[i] = std::max(MaxFrame[i], Current[i]);
+			Current.fill(0);
+		}
+
+		static void Reset() { MaxFrame.fill(0); }
+	};
+}
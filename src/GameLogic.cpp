@@ -27,6 +27,9 @@ namespace bsf
 	// maximum sonic height (jump) for collision
 	static constexpr float s_MaxCollisionHeight = 0.2f;
 
+	// How late a turn input can arrive and still be applied at the edge it was meant for
+	static constexpr float s_MaxLateTurnTime = 0.1f;
+
 
 	// Yellow spheres
 	static constexpr float s_YellowSphereDistance = 6.0f;
@@ -38,6 +41,12 @@ namespace bsf
 	// Emerald
 	static constexpr int32_t s_EmeraldDistanceHalf = 8;
 
+	// Event driven simulation. Events are overshot by a tiny amount, so that the
+	// edge crossing (or whatever) is actually detected by the state functions
+	static constexpr float s_EventDistanceEpsilon = 1e-3f;
+	static constexpr float s_EventTimeEpsilon = 1e-4f;
+	static constexpr uint32_t s_MaxEventSteps = 256;
+
 	// Directions
 	static constexpr glm::ivec2 s_dLeft = { -1, 0 };
 	static constexpr glm::ivec2 s_dRight = { 1, 0 };
@@ -247,7 +256,8 @@ namespace bsf
 
 		void Calculate()
 		{
-			BSF_DIAGNOSTIC_FUNC();
+			// Runs on the simulation thread, the profiler and the frame stats are main thread only
+			BSF_TRACE_SCOPE(__FUNCTION__);
 
 			// First of all we check if there's a nearby blue sphere. If not, the algorithm
 			// must not run
@@ -364,6 +374,7 @@ namespace bsf
 		m_RunForwardCommand = false;
 
 		m_State = EGameState::None;
+		m_SimulationMode = ESimulationMode::FixedStep;
 		m_Position = stage.StartPoint;
 		m_DeltaPosition = { 0, 0 };
 		m_Direction = stage.StartDirection;
@@ -386,6 +397,10 @@ namespace bsf
 		m_LastBounceDistance = 1.0f;
 		m_CurrentPace = s_MinPace;
 
+		m_TurnPoint = glm::round(m_Position);
+		m_TimeSinceTurnPoint = std::numeric_limits<float>::max();
+		m_DistanceSinceTurnPoint = 0.0f;
+
 		m_StateMap = {
 			{ EGameState::None,		&GameLogic::StateFnNone		},
 			{ EGameState::Starting, &GameLogic::StateFnStarting },
@@ -420,14 +435,112 @@ namespace bsf
 
 	void GameLogic::Advance(const Time& time)
 	{
+		if (m_SimulationMode == ESimulationMode::EventDriven)
+		{
+			AdvanceEventDriven(time);
+			return;
+		}
+
 		(this->*m_StateMap[m_State])(time);
 		// Wrap position inside boundary
 		m_Position = WrapPosition(m_Position);
 	}
 
-	void GameLogic::Rotate(ERotate r)
+	void GameLogic::AdvanceEventDriven(const Time& time)
+	{
+		// Between two events (edge crossing, rotation end, jump end, speed up, ...) the motion
+		// is linear, so instead of integrating with small steps we jump straight to the next event.
+		// The state functions are the same as the fixed step mode, so are the fired actions.
+		float remaining = time.Delta;
+
+		for (uint32_t i = 0; i < s_MaxEventSteps && remaining > 0.0f; i++)
+		{
+			const float step = std::min(remaining, GetTimeToNextEvent({ remaining, time.Elapsed - remaining }));
+			remaining -= step;
+			(this->*m_StateMap[m_State])({ step, time.Elapsed - remaining });
+			m_Position = WrapPosition(m_Position);
+		}
+
+		// Too many events in a single advance, just consume what's left
+		if (remaining > 0.0f)
+		{
+			(this->*m_StateMap[m_State])({ remaining, time.Elapsed });
+			m_Position = WrapPosition(m_Position);
+		}
+	}
+
+	float GameLogic::GetTimeToNextEvent(const Time& time) const
+	{
+		// Time is the time that is still to be simulated, so nothing happens
+		// if we return something bigger than time.Delta
+		float result = std::numeric_limits<float>::max();
+
+		// Unit velocity, the distance traveled in one second
+		const float velocity = CalculateStep({ 1.0f, 0.0f });
+
+		const auto distanceEvent = [&](float distance) {
+			result = std::min(result, (std::max(0.0f, distance) + s_EventDistanceEpsilon) / velocity);
+		};
+
+		const auto timeEvent = [&](float t) {
+			result = std::min(result, std::max(0.0f, t) + s_EventTimeEpsilon);
+		};
+
+		if (m_IsRotating)
+			timeEvent(std::abs(m_TargetRotationAngle - m_RotationAngle) / m_AngularVelocity);
+
+		switch (m_State)
+		{
+		case EGameState::None:
+			return 0.0f;
+		case EGameState::Starting:
+			timeEvent(3.0f - time.Elapsed);
+			break;
+		case EGameState::Playing:
+			if (m_CurrentPace < s_MaxPace)
+				timeEvent(s_SpeedUpPeriod - m_SpeedUpTimer.Elapsed);
+
+			if (!m_IsRotating)
+			{
+				// Next edge crossing. We only move along one axis
+				const size_t axis = m_Direction.x != 0 ? 0 : 1;
+				const float coord = m_Position[axis];
+				distanceEvent(m_Direction[axis] > 0 ? std::floor(coord) + 1.0f - coord : coord - std::floor(coord));
+
+				if (m_IsJumping)
+					distanceEvent(m_RemainingJumpDistance);
+
+				if (m_LastBounceDistance < 1.0f)
+					distanceEvent(1.0f - m_LastBounceDistance);
+			}
+			break;
+		case EGameState::Emerald:
+			distanceEvent(m_EmeraldDistance / 2.0f);
+			if (m_IsJumping)
+				distanceEvent(m_RemainingJumpDistance);
+			break;
+		default:
+			break;
+		}
+
+		return result;
+	}
+
+	void GameLogic::Rotate(ERotate r, float age)
 	{
 		m_RotateCommand = r;
+
+		// The input happened before the last edge where we could turn, but got here
+		// only now: go back to that edge and turn there, as if it arrived in time.
+		// Inputs older than the tolerance are never rewound, whatever delayed them
+		if (m_State == EGameState::Playing && !m_IsRotating && !m_IsJumping &&
+			age <= s_MaxLateTurnTime && age >= m_TimeSinceTurnPoint && m_TimeSinceTurnPoint <= s_MaxLateTurnTime)
+		{
+			m_DeltaPosition -= glm::vec2(m_Direction) * m_DistanceSinceTurnPoint;
+			m_Position = WrapPosition(m_TurnPoint);
+			m_TimeSinceTurnPoint = std::numeric_limits<float>::max();
+			PullRotateCommand();
+		}
 	}
 
 	void GameLogic::Jump()
@@ -478,7 +591,7 @@ namespace bsf
 		{
 			m_SpeedUpTimer -= s_SpeedUpPeriod;
 			m_CurrentPace += 1;
-			GameAction.Emit({ EGameAction::GameSpeedUp });
+			m_Actions.Push(EGameAction::GameSpeedUp);
 		}
 
 		// Update the current velocity(ies) based on the game pace
@@ -519,7 +632,7 @@ namespace bsf
 					m_Stage.SetValueAt(roundedPosition, EStageObject::RedSphere);
 
 					// Fire event
-					GameAction.Emit({ EGameAction::BlueSphereCollected });
+					m_Actions.Push(EGameAction::BlueSphereCollected);
 
 					// Run the ring conversion algorithm
 					TransformRingAlgorithm(m_Stage, roundedPosition).Calculate();
@@ -527,9 +640,9 @@ namespace bsf
 					if (m_Stage.GetValueAt(roundedPosition) == EStageObject::Ring)
 					{
 						m_Stage.CollectRing(roundedPosition);
-						GameAction.Emit({ EGameAction::RingCollected });
+						m_Actions.Push(EGameAction::RingCollected);
 						if (m_Stage.IsPerfect())
-							GameAction.Emit({ EGameAction::Perfect });
+							m_Actions.Push(EGameAction::Perfect);
 					}
 
 					// If there are no more blue spheres the game is over
@@ -565,8 +678,8 @@ namespace bsf
 					m_IsGoingBackward = !m_IsGoingBackward;
 					m_Direction *= -1;
 					m_Position = roundedPosition; // Snap to star sphere
-					GameAction.Emit({ EGameAction::HitBumper });
-					GameAction.Emit({ m_IsGoingBackward ? EGameAction::GoBackward : EGameAction::GoForward });
+					m_Actions.Push(EGameAction::HitBumper);
+					m_Actions.Push(m_IsGoingBackward ? EGameAction::GoBackward : EGameAction::GoForward);
 
 				}
 				else if (object == EStageObject::YellowSphere)
@@ -576,7 +689,7 @@ namespace bsf
 					m_JumpHeight = s_YellowSphereHeight;
 					m_JumpVelocityScale = 2.0f;
 					m_IsJumping = true;
-					GameAction.Emit({ EGameAction::YellowSphereJumpStart });
+					m_Actions.Push(EGameAction::YellowSphereJumpStart);
 				}
 				else if (object == EStageObject::RedSphere)
 				{
@@ -585,13 +698,13 @@ namespace bsf
 				else if (object == EStageObject::Ring)
 				{
 					m_Stage.CollectRing(roundedPosition);
-					GameAction.Emit({ EGameAction::RingCollected });
+					m_Actions.Push(EGameAction::RingCollected);
 					if (m_Stage.IsPerfect())
-						GameAction.Emit({ EGameAction::Perfect });
+						m_Actions.Push(EGameAction::Perfect);
 				}
 				else if (object == EStageObject::GreenSphere)
 				{
-					GameAction.Emit({ EGameAction::GreenSphereCollected });
+					m_Actions.Push(EGameAction::GreenSphereCollected);
 					m_Stage.SetValueAt(roundedPosition, EStageObject::BlueSphere);
 				}
 
@@ -606,7 +719,7 @@ namespace bsf
 				m_IsJumping = true;
 				m_JumpCommand = false;
 				m_JumpVelocityScale = 1.0f;
-				GameAction.Emit({ EGameAction::NormalJumpStart });
+				m_Actions.Push(EGameAction::NormalJumpStart);
 			}
 
 			HandleJump(step);
@@ -617,7 +730,8 @@ namespace bsf
 				m_RunForwardCommand = false;
 				m_IsGoingBackward = false;
 				m_Direction *= -1;
-				GameAction.Emit({ EGameAction::GoForward });
+				m_TimeSinceTurnPoint = std::numeric_limits<float>::max();
+				m_Actions.Push(EGameAction::GoForward);
 			}
 
 			// If we crossed and edge and there's a rotation request,
@@ -630,9 +744,28 @@ namespace bsf
 			// We don't want to pull rotate commands if it's "GameOver" or "Emerald"
 			if (m_State == EGameState::Playing)
 			{
-				if (crossed && m_LastBounceDistance == 1.0f && !m_IsJumping && PullRotateCommand())
+				const bool canTurn = crossed && m_LastBounceDistance == 1.0f && !m_IsJumping;
+
+				if (canTurn && PullRotateCommand())
 				{
 					m_Position = glm::round(m_Position);
+					m_TimeSinceTurnPoint = std::numeric_limits<float>::max();
+				}
+				else if (canTurn)
+				{
+					// Remember the edge for turn inputs that arrive late (see Rotate)
+					m_TurnPoint = glm::round(m_Position);
+					m_TimeSinceTurnPoint = 0.0f;
+					m_DistanceSinceTurnPoint = glm::distance(m_Position, m_TurnPoint);
+				}
+				else if (crossed)
+				{
+					m_TimeSinceTurnPoint = std::numeric_limits<float>::max();
+				}
+				else
+				{
+					m_TimeSinceTurnPoint += time.Delta;
+					m_DistanceSinceTurnPoint += step;
 				}
 			}
 
@@ -676,7 +809,7 @@ namespace bsf
 			{
 				m_IsJumping = false;
 				m_JumpVelocityScale = 1.0f;
-				GameAction.Emit({ EGameAction::JumpEnd });
+				m_Actions.Push(EGameAction::JumpEnd);
 			}
 
 		}
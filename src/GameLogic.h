@@ -41,11 +41,55 @@ namespace bsf
 		EGameAction Action;
 	};
 
+	// Game actions are queued during the simulation steps instead of being emitted, so that
+	// the consumers (audio, UI...) can handle them once per frame. When the queue is full the
+	// oldest action is overwritten, so it's fine to never drain it (headless runs)
+	class GameActionQueue
+	{
+	public:
+		static constexpr size_t Capacity = 64;
+
+		void Push(EGameAction action)
+		{
+			m_Actions[(m_Head + m_Count) % Capacity] = { action };
+
+			if (m_Count < Capacity)
+				m_Count++;
+			else
+				m_Head = (m_Head + 1) % Capacity;
+		}
+
+		template<typename Fn>
+		void Drain(Fn&& fn)
+		{
+			for (; m_Count > 0; m_Count--)
+			{
+				fn(m_Actions[m_Head]);
+				m_Head = (m_Head + 1) % Capacity;
+			}
+		}
+
+		void Clear() { m_Head = m_Count = 0; }
+
+		size_t Size() const { return m_Count; }
+		bool Empty() const { return m_Count == 0; }
+
+	private:
+		std::array<GameActionEvent, Capacity> m_Actions;
+		size_t m_Head = 0, m_Count = 0;
+	};
+
 	struct GameStateChangedEvent
 	{
 		EGameState Old, Current;
 	};
 
+	enum class ESimulationMode : uint8_t
+	{
+		FixedStep,
+		EventDriven
+	};
+
 
 	class GameLogic
 	{
@@ -58,13 +102,17 @@ namespace bsf
 			Right = -1
 		};
 
-		EventEmitter<GameActionEvent> GameAction;
 		EventEmitter<GameStateChangedEvent> GameStateChanged;
 
 		GameLogic(Stage& stage);
 
 		void Advance(const Time& time);
 
+		GameActionQueue& GetActions() { return m_Actions; }
+
+		void SetSimulationMode(ESimulationMode mode) { m_SimulationMode = mode; }
+		ESimulationMode GetSimulationMode() const { return m_SimulationMode; }
+
 		float GetHeight() const { return m_Height; }
 		
 		glm::vec2 GetPosition() const;
@@ -96,7 +144,8 @@ namespace bsf
 
 		glm::vec2 WrapPosition(const glm::vec2& pos) const;
 
-		void Rotate(ERotate r);
+		// Age is how long ago the input happened, in simulation time
+		void Rotate(ERotate r, float age = 0.0f);
 		void Jump();
 		void RunForward();
 
@@ -125,6 +174,8 @@ namespace bsf
 		bool m_IsRotating;
 
 		ERotate m_RotateCommand;
+		glm::vec2 m_TurnPoint;
+		float m_TimeSinceTurnPoint, m_DistanceSinceTurnPoint;
 		bool m_RunForwardCommand;
 		bool m_JumpCommand;
 
@@ -135,7 +186,10 @@ namespace bsf
 		float m_EmeraldDistance;
 		bool m_IsEmeraldVisible;
 
+		GameActionQueue m_Actions;
+
 		EGameState m_State;
+		ESimulationMode m_SimulationMode;
 		Stage& m_Stage;
 
 		std::unordered_map<EGameState, StateFnPtr> m_StateMap;
@@ -156,6 +210,9 @@ namespace bsf
 		void HandleJump(float step);
 
 		float CalculateStep(const Time& time) const;
+
+		void AdvanceEventDriven(const Time& time);
+		float GetTimeToNextEvent(const Time& time) const;
 	};
 }
 
@@ -5,7 +5,7 @@
 #include "ShaderProgram.h"
 #include "Texture.h"
 #include "Framebuffer.h"
-#include "GameLogic.h"
+#include "GameSimulation.h"
 #include "Log.h"
 #include "Assets.h"
 #include "Renderer2D.h"
@@ -23,6 +23,7 @@
 #include "Character.h"
 #include "Bloom.h"
 #include "Table.h"
+#include "Config.h"
 
 namespace bsf
 {
@@ -41,6 +42,7 @@ namespace bsf
 	static constexpr float s_RingSparklesMinDistance = 0.1f; 
 	static constexpr float s_RingSparklesMaxDistance = 0.2f; 
 	static constexpr float s_RingSparklesRotationSpeed = glm::pi<float>();
+	static constexpr uint32_t s_RingSparklesPerRing = 3;
 
 
 	static constexpr Table<7, EStageObject, glm::vec4> s_ObjectColor = {
@@ -67,7 +69,8 @@ namespace bsf
 
 		auto windowSize = app.GetWindowSize();
 
-		m_GameLogic = MakeRef<GameLogic>(*m_Stage);
+		const auto simulationMode = Config::Load().EventDrivenSimulation ? ESimulationMode::EventDriven : ESimulationMode::FixedStep;
+		m_Simulation = MakeRef<GameSimulation>(m_Stage, simulationMode);
 
 		// Framebuffers
 		m_fbPBR = MakeRef<Framebuffer>(windowSize.x, windowSize.y, true);
@@ -97,34 +100,33 @@ namespace bsf
 
 		// Event hanlders
 		AddSubscription(app.WindowResized, this, &GameScene::OnResize);
-		AddSubscription(m_GameLogic->GameStateChanged, this, &GameScene::OnGameStateChanged);
-		AddSubscription(m_GameLogic->GameAction, this, &GameScene::OnGameAction);
 
 		AddSubscription(app.KeyPressed, [&](const KeyPressedEvent& evt) {
 			if (evt.KeyCode == GLFW_KEY_LEFT)
 			{
-				m_GameLogic->Rotate(GameLogic::ERotate::Left);
+				m_Simulation->Send(EGameCommand::RotateLeft, evt.Timestamp);
 			}
 			else if (evt.KeyCode == GLFW_KEY_RIGHT)
 			{
-				m_GameLogic->Rotate(GameLogic::ERotate::Right);
+				m_Simulation->Send(EGameCommand::RotateRight, evt.Timestamp);
 			}
 			else if (evt.KeyCode == GLFW_KEY_UP)
 			{
-				m_GameLogic->RunForward();
+				m_Simulation->Send(EGameCommand::RunForward, evt.Timestamp);
 			}
 			else if (evt.KeyCode == GLFW_KEY_SPACE)
 			{
-				m_GameLogic->Jump();
+				m_Simulation->Send(EGameCommand::Jump, evt.Timestamp);
 			}
 			else if (evt.KeyCode == GLFW_KEY_ENTER)
 			{
 				m_Paused = !m_Paused;
+				m_Simulation->SetPaused(m_Paused);
 			}
 
 		});
 
-		auto fadeIn = MakeRef<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), 0.5f);
+		auto fadeIn = CreateTask<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), 0.5f);
 		ScheduleTask(ESceneTaskEvent::PostRender, fadeIn);
 
 		// Play music
@@ -132,6 +134,8 @@ namespace bsf
 		music->SetVolume(1.0f);
 		music->Play();
 
+		m_Simulation->Start();
+		m_Simulation->UpdateSnapshot();
 	}
 
 	void GameScene::OnRender(const Time& time)
@@ -157,23 +161,36 @@ namespace bsf
 		const auto texBumperMetallic = assets.Get<Texture2D>(AssetName::TexBumperMetallic);
 		const auto texBumperRoughness = assets.Get<Texture2D>(AssetName::TexBumperRoughness);
 
+		// The simulation runs on its own thread, here we only pick up its latest state
 		if (!m_Paused)
 		{
-			constexpr size_t steps = 5;
-			for (size_t i = 0; i < steps; i++)
-				m_GameLogic->Advance({ time.Delta / steps, time.Elapsed });
-
-			character->SetAnimationGlobalTimeWarp(m_GameLogic->GetNormalizedVelocity() * (m_GameLogic->IsGoindBackward() ? -1.0f : 1.0f));
-			character->Update(time);
+			m_Simulation->UpdateSnapshot();
+			ProcessGameActions();
 		}
 
+		const GameSnapshot& snapshot = m_Simulation->GetSnapshot();
 
+		if (!m_Paused)
+		{
+			character->SetAnimationGlobalTimeWarp(snapshot.NormalizedVelocity * (snapshot.IsGoingBackward ? -1.0f : 1.0f));
+			character->Update(time);
+		}
 
-		glm::vec2 pos = m_GameLogic->GetPosition();
-		glm::vec2 deltaPos = m_GameLogic->GetDeltaPosition();
-		glm::vec2 viewDir = m_GameLogic->GetViewDirection();
+		// Drawn one tick behind, between the last two ticks, so that the motion of a frame doesn't
+		// depend on how many ticks ended in it
+		const float alpha = glm::clamp(std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.TickTime).count() * GameSimulation::TickRate, 0.0f, 1.0f);
+		const float rotationAngle = glm::mix(snapshot.PreviousRotationAngle, snapshot.RotationAngle, alpha);
+		const float height = glm::mix(snapshot.PreviousHeight, snapshot.Height, alpha);
+		const glm::vec2 totalDeltaPosition = glm::mix(snapshot.PreviousTotalDeltaPosition, snapshot.TotalDeltaPosition, alpha);
+
+		glm::vec2 pos = glm::mix(snapshot.PreviousPosition, snapshot.Position, alpha);
+		glm::vec2 deltaPos = totalDeltaPosition - m_LastTotalDeltaPosition;
+		glm::vec2 viewDir = { std::cos(rotationAngle), std::sin(rotationAngle) };
+		m_LastTotalDeltaPosition = totalDeltaPosition;
 		glm::vec2 viewOrigin = -viewDir;
-		int32_t ix = pos.x, iy = pos.y;
+
+		// The objects are around the cell of the snapshot, the offset can be a bit out of it
+		int32_t ix = snapshot.Position.x, iy = snapshot.Position.y;
 		float fx = pos.x - ix, fy = pos.y - iy;
 
 		const auto setupView = [&]() {
@@ -185,7 +202,7 @@ namespace bsf
 			m_Model.LoadIdentity();
 
 			m_View.LookAt({ -1.5f, 2.5f, 0.0f }, { 1.0f, 0.0, 0.0f }, { 0.0f, 1.0f, 0.0f });
-			m_View.Rotate({ 0.0f, 1.0f, 0.0f }, -m_GameLogic->GetRotationAngle());
+			m_View.Rotate({ 0.0f, 1.0f, 0.0f }, -rotationAngle);
 			m_Model.Rotate({ 1.0f, 0.0f, 0.0f }, -glm::pi<float>() / 2.0f);
 		};
 
@@ -212,6 +229,7 @@ namespace bsf
 		// Draw ground reflections
 		m_fbGroundReflections->Bind();
 		{
+			BSF_DIAGNOSTIC_GPU_SCOPE("Reflections");
 
 			GLEnableScope scope({ GL_DEPTH_TEST, GL_CULL_FACE });
 
@@ -233,10 +251,10 @@ namespace bsf
 
 				m_Model.Scale({ 1.0f, 1.0f, -1.0f });
 
-				if (m_GameLogic->IsJumping())
-					m_Model.Translate({ 0.0f, 0.0f, m_GameLogic->GetHeight() });
+				if (snapshot.IsJumping)
+					m_Model.Translate({ 0.0f, 0.0f, height });
 
-				m_Model.Rotate({ 0.0f, 0.0f, 1.0f }, m_GameLogic->GetRotationAngle());
+				m_Model.Rotate({ 0.0f, 0.0f, 1.0f }, rotationAngle);
 				m_Model.Multiply(character->Matrix);
 
 				m_pSkeletalReflections->Use();
@@ -295,7 +313,7 @@ namespace bsf
 				{
 					for (int32_t y = -s_SightRadius; y <= s_SightRadius; y++)
 					{
-						auto value = m_Stage->GetValueAt(x + ix, y + iy);
+						auto value = snapshot.GetValueAt(x, y);
 
 						if (value == EStageObject::None || !isObjectVisible({ x - fx, y - fy }))
 							continue;
@@ -369,10 +387,10 @@ namespace bsf
 			}
 
 			// Emerald
-			if (m_GameLogic->IsEmeraldVisible())
+			if (snapshot.IsEmeraldVisible)
 			{
 
-				auto emeraldPos = glm::vec2(m_GameLogic->GetDirection()) * m_GameLogic->GetEmeraldDistance();
+				auto emeraldPos = glm::vec2(snapshot.Direction) * snapshot.EmeraldDistance;
 				auto [visible, pos, tbn] = Reflect(cameraWorldPosition, { emeraldPos.x, emeraldPos.y, 0.8f }, 0.15f);
 
 				if (visible)
@@ -407,6 +425,7 @@ namespace bsf
 
 			// Draw Sky
 			{
+				BSF_DIAGNOSTIC_GPU_SCOPE("Sky");
 				GLEnableScope scope({ GL_DEPTH_TEST });
 
 				glDisable(GL_DEPTH_TEST);
@@ -414,7 +433,7 @@ namespace bsf
 				m_View.Reset();
 				m_View.LoadIdentity();
 				m_View.LookAt({ 0.0f, 0.0f, 0.0f }, { 0.0f, -2.5f, -2.5f }, { 0.0f, 1.0f, 0.0f });
-				m_View.Rotate({ 0.0f, 1.0f, 0.0f }, -m_GameLogic->GetRotationAngle() + glm::pi<float>() / 2.0f);
+				m_View.Rotate({ 0.0f, 1.0f, 0.0f }, -rotationAngle + glm::pi<float>() / 2.0f);
 
 				m_Model.Reset();
 				m_Model.LoadIdentity();
@@ -432,6 +451,7 @@ namespace bsf
 
 			// Draw scene
 			{
+				BSF_DIAGNOSTIC_GPU_SCOPE("Scene");
 				GLEnableScope scope({ GL_DEPTH_TEST, GL_CULL_FACE });
 
 				glEnable(GL_CULL_FACE);
@@ -447,10 +467,10 @@ namespace bsf
 
 					m_Model.Push();
 
-					if (m_GameLogic->IsJumping())
-						m_Model.Translate({ 0.0f, 0.0f, m_GameLogic->GetHeight() });
+					if (snapshot.IsJumping)
+						m_Model.Translate({ 0.0f, 0.0f, height });
 
-					m_Model.Rotate({ 0.0f, 0.0f, 1.0f }, m_GameLogic->GetRotationAngle());
+					m_Model.Rotate({ 0.0f, 0.0f, 1.0f }, rotationAngle);
 					m_Model.Multiply(character->Matrix);
 
 					m_pSkeletalPBR->Use();
@@ -524,7 +544,7 @@ namespace bsf
 					{
 						for (int32_t y = -s_SightRadius; y <= s_SightRadius; y++)
 						{
-						auto value = m_Stage->GetValueAt(x + ix, y + iy);
+						auto value = snapshot.GetValueAt(x, y);
 
 						if (value == EStageObject::None || !isObjectVisible({ x - fx, y - fy }))
 							continue;
@@ -598,10 +618,10 @@ namespace bsf
 				}
 
 				// Draw Emerald if visible
-				if (m_GameLogic->IsEmeraldVisible())
+				if (snapshot.IsEmeraldVisible)
 				{
 
-					auto emeraldPos = glm::vec2(m_GameLogic->GetDirection()) * m_GameLogic->GetEmeraldDistance();
+					auto emeraldPos = glm::vec2(snapshot.Direction) * snapshot.EmeraldDistance;
 					auto [pos, tbn] = Project({ emeraldPos.x, emeraldPos.y, 0.8f });
 
 					m_pPBR->UniformTexture(HS("uMap"), texWhite);
@@ -627,6 +647,7 @@ namespace bsf
 			
 
 			if(!m_RingSparkles.Empty()) {
+				BSF_DIAGNOSTIC_GPU_SCOPE("Sparkles");
 				auto projectedOrigin = m_Projection.GetMatrix() * m_View.GetMatrix() * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 				RenderRingSparkles(projectedOrigin, time);
 			}
@@ -636,10 +657,14 @@ namespace bsf
 
 		m_fbPBR->Unbind();
 
-		m_fxBloom->Apply();
+		{
+			BSF_DIAGNOSTIC_GPU_SCOPE("Bloom");
+			m_fxBloom->Apply();
+		}
 
 		// Draw to default frame buffer
 		{
+			BSF_DIAGNOSTIC_GPU_SCOPE("Deferred");
 			GLEnableScope scope({ GL_FRAMEBUFFER_SRGB });
 
 			glEnable(GL_FRAMEBUFFER_SRGB);
@@ -656,13 +681,16 @@ namespace bsf
 
 		}
 
-
-		RenderGameUI(time);
+		{
+			BSF_DIAGNOSTIC_GPU_SCOPE("UI");
+			RenderGameUI(time);
+		}
 
 	}
 
 	void GameScene::OnDetach()
 	{
+		m_Simulation->Stop();
 	}
 
 	void GameScene::OnResize(const WindowResizedEvent& evt)
@@ -723,6 +751,7 @@ namespace bsf
 
 		// Counters (spheres and rings)
 		{
+			const auto& snapshot = m_Simulation->GetSnapshot();
 			constexpr float shadowOffset = 0.03f;
 			constexpr float padding = 0.5f;
 			constexpr float sw = 25.0f;
@@ -731,7 +760,7 @@ namespace bsf
 			renderer2d.Begin(glm::ortho(0.0f, sw, 0.0f, sh, -1.0f, 1.0f));
 
 			{
-				auto blueSpheres = std::to_string(m_Stage->Count(EStageObject::BlueSphere));
+				auto blueSpheres = std::to_string(snapshot.BlueSpheres);
 				renderer2d.Push();
 				renderer2d.Pivot(EPivot::TopLeft);
 				renderer2d.Translate({ padding, sh - padding });
@@ -756,7 +785,7 @@ namespace bsf
 
 
 			{
-				auto rings = std::to_string(m_Stage->Rings);
+				auto rings = std::to_string(snapshot.Rings);
 				renderer2d.Push();
 				renderer2d.Pivot(EPivot::TopRight);
 				renderer2d.Translate({ sw - padding, sh - padding });
@@ -826,7 +855,7 @@ namespace bsf
 
 		if (evt.Current == EGameState::GameOver)
 		{
-			auto task = MakeRef<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 2.0f);
+			auto task = CreateTask<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 2.0f);
 
 			assets.Get<Audio>(AssetName::SfxGameOver)->Play();
 
@@ -836,10 +865,13 @@ namespace bsf
 
 			task->SetDoneFunction([&](SceneTask& self) {
 
-				if (m_Stage->Count(EStageObject::BlueSphere) == 0)
+				m_Simulation->UpdateSnapshot();
+				const auto& snapshot = m_Simulation->GetSnapshot();
+
+				if (snapshot.BlueSpheres == 0)
 				{
 					// Victory
-					auto scene = MakeRef<StageClearScene>(m_GameInfo, m_Stage->GetCollectedRings(), m_Stage->IsPerfect());
+					auto scene = MakeRef<StageClearScene>(m_GameInfo, snapshot.CollectedRings, snapshot.IsPerfect);
 					GetApplication().GotoScene(scene);
 				}
 				else
@@ -860,7 +892,7 @@ namespace bsf
 			assets.Get<Audio>(AssetName::SfxMusic)->SetVolume(0.5f);
 
 
-			auto liftObjectsTask = MakeRef<SceneTask>();
+			auto liftObjectsTask = CreateTask<SceneTask>();
 			liftObjectsTask->SetUpdateFunction([&](SceneTask& self, const Time& time) {
 				//m_GameOverObjectsHeight += time.Delta * 10.0f;
 				m_GameOverObjectsHeight += time.Delta * 5.0f;
@@ -868,7 +900,7 @@ namespace bsf
 
 			ScheduleTask(ESceneTaskEvent::PreRender, liftObjectsTask);
 
-			auto playEmeraldSound = MakeRef<SceneTask>();
+			auto playEmeraldSound = CreateTask<SceneTask>();
 
 			playEmeraldSound->SetUpdateFunction([&, emeraldTime = 0.0f](SceneTask& self, const Time& time) mutable {
 
@@ -887,6 +919,46 @@ namespace bsf
 		}
 	}
 
+	void GameScene::ProcessGameActions()
+	{
+		// Actions and state changes sent by the simulation thread since the last frame.
+		// The sounds of these actions are coalesced, e.g. multiple rings in the same frame
+		// play the ring sound once. Everything else is still done for each of them
+		static constexpr std::array<EGameAction, 6> s_CoalescedActions = {
+			EGameAction::RingCollected,
+			EGameAction::BlueSphereCollected,
+			EGameAction::GreenSphereCollected,
+			EGameAction::HitBumper,
+			EGameAction::Perfect,
+			EGameAction::GameSpeedUp
+		};
+
+		uint32_t handled = 0;
+
+		m_Simulation->DrainEvents([&](const GameSimulationEvent& e) {
+			if (e.Type == GameSimulationEvent::EType::StateChanged)
+			{
+				OnGameStateChanged(e.StateChanged);
+				return;
+			}
+
+			const GameActionEvent& evt = e.Action;
+			const uint32_t mask = 1u << uint32_t(evt.Action);
+
+			if ((handled & mask) != 0)
+			{
+				if (evt.Action == EGameAction::RingCollected)
+					m_RingSparkles.Emit(s_RingSparklesPerRing);
+				return;
+			}
+
+			if (std::find(s_CoalescedActions.begin(), s_CoalescedActions.end(), evt.Action) != s_CoalescedActions.end())
+				handled |= mask;
+
+			OnGameAction(evt);
+		});
+	}
+
 	void GameScene::OnGameAction(const GameActionEvent& evt)
 	{
 		auto& assets = Assets::GetInstance();
@@ -910,7 +982,7 @@ namespace bsf
 		case EGameAction::GoBackward:
 			break;
 		case EGameAction::RingCollected:
-			m_RingSparkles.Emit(3);
+			m_RingSparkles.Emit(s_RingSparklesPerRing);
 			assets.Get<Audio>(AssetName::SfxRing)->Play();
 			break;
 		case EGameAction::Perfect:
@@ -950,7 +1022,8 @@ namespace bsf
 
 	void GameScene::RenderEmerald(const Ref<ShaderProgram>& currentProgram, const Time& time, MatrixStack& model)
 	{
-		auto emeraldPos = glm::vec2(m_GameLogic->GetDirection()) * m_GameLogic->GetEmeraldDistance();
+		const auto& snapshot = m_Simulation->GetSnapshot();
+		auto emeraldPos = glm::vec2(snapshot.Direction) * snapshot.EmeraldDistance;
 		auto [pos, tbn] = Project({ emeraldPos.x, emeraldPos.y, 0.8f });
 
 		model.Push();
@@ -12,7 +12,7 @@ namespace bsf
 	class BlurFilter;
 	class ShaderProgram;
 	class Stage;
-	class GameLogic;
+	class GameSimulation;
 	class Texture2D;
 	class TextureCube;
 	class Framebuffer;
@@ -80,7 +80,8 @@ namespace bsf
 		
 		Ref<Sky> m_Sky;
 		Ref<Texture2D> m_txGroundMap;
-		Ref<GameLogic> m_GameLogic;
+		Ref<GameSimulation> m_Simulation;
+		glm::vec2 m_LastTotalDeltaPosition = { 0.0f, 0.0f };
 
 		RingSparkleEmitter m_RingSparkles;
 		
@@ -94,6 +95,7 @@ namespace bsf
 		
 		void OnGameStateChanged(const GameStateChangedEvent& evt);
 		void OnGameAction(const GameActionEvent& action);
+		void ProcessGameActions();
 
 		void RotateSky(const glm::vec2& deltaPosition);
 
@@ -0,0 +1,214 @@
+#include "BsfPch.h"
+
+#include "GameSimulation.h"
+#include "Stage.h"
+#include "Diagnostic.h"
+#include "Log.h"
+
+namespace bsf
+{
+	// A tick pushes at most the whole action queue and a couple of state changes
+	static constexpr size_t s_MaxEventsPerTick = GameActionQueue::Capacity + 4;
+
+	// After a stall longer than this the lost time is dropped instead of simulated
+	static constexpr uint32_t s_MaxTicksPerWake = 30;
+
+	GameSimulation::GameSimulation(const Ref<Stage>& stage, ESimulationMode mode) :
+		m_Stage(stage),
+		m_GameLogic(*stage)
+	{
+		m_GameLogic.SetSimulationMode(mode);
+
+		m_StateChangedSubscription = m_GameLogic.GameStateChanged.Subscribe([&](const GameStateChangedEvent& evt) {
+			// Keep the order: the actions of this tick that came before the state change go first
+			FlushActions();
+
+			GameSimulationEvent e = {};
+			e.Type = GameSimulationEvent::EType::StateChanged;
+			e.StateChanged = evt;
+			m_Events.Push(e);
+		});
+	}
+
+	GameSimulation::~GameSimulation()
+	{
+		Stop();
+		m_StateChangedSubscription();
+	}
+
+	void GameSimulation::Start()
+	{
+		assert(!m_Thread.joinable());
+
+		// The renderer always has a snapshot to read, even before the first tick
+		m_TickTime = std::chrono::steady_clock::now();
+		SavePreviousTick();
+		Publish();
+
+		m_Running.store(true, std::memory_order_relaxed);
+		m_Thread = std::thread(&GameSimulation::Run, this);
+	}
+
+	void GameSimulation::Stop()
+	{
+		if (!m_Thread.joinable())
+			return;
+
+		m_Running.store(false, std::memory_order_relaxed);
+		m_Thread.join();
+	}
+
+	void GameSimulation::Send(EGameCommand command, InputTimestamp timestamp)
+	{
+		if (!m_Commands.Push({ command, timestamp }))
+			BSF_ERROR("Game command queue is full");
+	}
+
+	void GameSimulation::Run()
+	{
+		using Clock = std::chrono::steady_clock;
+
+		const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0f / TickRate));
+		const float delta = 1.0f / TickRate;
+
+		auto nextTick = Clock::now();
+
+		while (m_Running.load(std::memory_order_relaxed))
+		{
+			BSF_TRACE_SCOPE("GameSimulation");
+
+			const auto now = Clock::now();
+
+			// While paused, or while the render thread doesn't drain the events (e.g. the
+			// window is being dragged), the simulation waits instead of losing them
+			if (m_Paused.load(std::memory_order_relaxed) || m_Events.GetFreeSpace() < s_MaxEventsPerTick)
+			{
+				nextTick = now + tickDuration;
+				m_ResumeTime = now;
+				std::this_thread::sleep_until(nextTick);
+				continue;
+			}
+
+			uint32_t ticks = 0;
+
+			for (; nextTick <= now && ticks < s_MaxTicksPerWake; ticks++)
+			{
+				m_Time.Delta = delta;
+				m_Time.Elapsed += delta;
+				Tick(m_Time, nextTick);
+				nextTick += tickDuration;
+
+				if (m_Events.GetFreeSpace() < s_MaxEventsPerTick)
+					break;
+			}
+
+			if (ticks == s_MaxTicksPerWake)
+				nextTick = now + tickDuration;
+
+			if (ticks > 0)
+				Publish();
+
+			std::this_thread::sleep_until(nextTick);
+		}
+	}
+
+	void GameSimulation::Tick(const Time& time, InputTimestamp tickEnd)
+	{
+		using Seconds = std::chrono::duration<float>;
+
+		const InputTimestamp tickStart = tickEnd - std::chrono::duration_cast<InputTimestamp::duration>(Seconds(time.Delta));
+
+		// Commands newer than this tick stay queued for the next ones
+		for (auto command = m_Commands.Front(); command != nullptr && command->Timestamp <= tickEnd; command = m_Commands.Front())
+		{
+			// Commands queued while the simulation was waiting are aged from when it resumed
+			const float age = std::max(0.0f, Seconds(tickStart - std::max(command->Timestamp, m_ResumeTime)).count());
+
+			switch (command->Command)
+			{
+			case EGameCommand::RotateLeft: m_GameLogic.Rotate(GameLogic::ERotate::Left, age); break;
+			case EGameCommand::RotateRight: m_GameLogic.Rotate(GameLogic::ERotate::Right, age); break;
+			case EGameCommand::RunForward: m_GameLogic.RunForward(); break;
+			case EGameCommand::Jump: m_GameLogic.Jump(); break;
+			}
+
+			m_Commands.Pop();
+		}
+
+		SavePreviousTick();
+		m_GameLogic.Advance(time);
+		m_TotalDeltaPosition += m_GameLogic.GetDeltaPosition();
+		m_TickTime = tickEnd;
+
+		// Only collecting something changes the stage
+		if (!m_GameLogic.GetActions().Empty())
+			m_StageChanged = true;
+
+		FlushActions();
+	}
+
+	void GameSimulation::FlushActions()
+	{
+		m_GameLogic.GetActions().Drain([&](const GameActionEvent& evt) {
+			GameSimulationEvent e = {};
+			e.Type = GameSimulationEvent::EType::Action;
+			e.Action = evt;
+			m_Events.Push(e);
+		});
+	}
+
+	void GameSimulation::SavePreviousTick()
+	{
+		m_PreviousPosition = m_GameLogic.GetPosition();
+		m_PreviousTotalDeltaPosition = m_TotalDeltaPosition;
+		m_PreviousRotationAngle = m_GameLogic.GetRotationAngle();
+		m_PreviousHeight = m_GameLogic.GetHeight();
+	}
+
+	void GameSimulation::Publish()
+	{
+		auto& snapshot = m_Snapshots.GetWriteBuffer();
+
+		const glm::vec2 position = m_GameLogic.GetPosition();
+
+		// Positions wrap around the stage, the previous one is moved next to the current one
+		const float stageSize = float(m_Stage->GetSize());
+		glm::vec2 move = position - m_PreviousPosition;
+		move -= glm::round(move / stageSize) * stageSize;
+
+		snapshot.TickTime = m_TickTime;
+		snapshot.Position = position;
+		snapshot.PreviousPosition = position - move;
+		snapshot.PreviousTotalDeltaPosition = m_PreviousTotalDeltaPosition;
+		snapshot.PreviousRotationAngle = m_PreviousRotationAngle;
+		snapshot.PreviousHeight = m_PreviousHeight;
+		snapshot.TotalDeltaPosition = m_TotalDeltaPosition;
+		snapshot.Direction = m_GameLogic.GetDirection();
+		snapshot.RotationAngle = m_GameLogic.GetRotationAngle();
+		snapshot.Height = m_GameLogic.GetHeight();
+		snapshot.NormalizedVelocity = m_GameLogic.GetNormalizedVelocity();
+		snapshot.EmeraldDistance = m_GameLogic.GetEmeraldDistance();
+		snapshot.IsJumping = m_GameLogic.IsJumping();
+		snapshot.IsGoingBackward = m_GameLogic.IsGoindBackward();
+		snapshot.IsEmeraldVisible = m_GameLogic.IsEmeraldVisible();
+
+		if (m_StageChanged)
+		{
+			m_BlueSpheres = m_Stage->Count(EStageObject::BlueSphere);
+			m_StageChanged = false;
+		}
+
+		snapshot.BlueSpheres = m_BlueSpheres;
+		snapshot.Rings = m_Stage->Rings;
+		snapshot.CollectedRings = m_Stage->GetCollectedRings();
+		snapshot.IsPerfect = m_Stage->IsPerfect();
+
+		const int32_t ix = int32_t(position.x), iy = int32_t(position.y);
+
+		for (int32_t y = -s_SightRadius; y <= s_SightRadius; y++)
+			for (int32_t x = -s_SightRadius; x <= s_SightRadius; x++)
+				snapshot.Objects[size_t(y + s_SightRadius) * GameSnapshot::WindowSize + size_t(x + s_SightRadius)] = m_Stage->GetValueAt(x + ix, y + iy);
+
+		m_Snapshots.Publish();
+	}
+}
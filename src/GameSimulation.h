@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Common.h"
+#include "GameLogic.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+namespace bsf
+{
+	class Stage;
+	enum class EStageObject : uint32_t;
+
+	enum class EGameCommand : uint8_t
+	{
+		RotateLeft,
+		RotateRight,
+		RunForward,
+		Jump
+	};
+
+	struct GameCommand
+	{
+		EGameCommand Command;
+		InputTimestamp Timestamp;
+	};
+
+	// Everything the renderer needs from a simulation tick. The stage objects are copied
+	// only around the player, as far as they can be seen. The motion of the previous tick
+	// is there too, so that the renderer can interpolate between the two
+	struct GameSnapshot
+	{
+		static constexpr int32_t WindowSize = s_SightRadius * 2 + 1;
+
+		// When the tick ended
+		InputTimestamp TickTime = {};
+
+		glm::vec2 Position = { 0.0f, 0.0f };
+		glm::vec2 TotalDeltaPosition = { 0.0f, 0.0f };
+		glm::ivec2 Direction = { 1, 0 };
+		float RotationAngle = 0.0f;
+		float Height = 0.0f;
+
+		// Previous tick, the position is unwrapped so that it's close to the current one
+		glm::vec2 PreviousPosition = { 0.0f, 0.0f };
+		glm::vec2 PreviousTotalDeltaPosition = { 0.0f, 0.0f };
+		float PreviousRotationAngle = 0.0f;
+		float PreviousHeight = 0.0f;
+
+		float NormalizedVelocity = 0.0f;
+		float EmeraldDistance = 0.0f;
+		bool IsJumping = false;
+		bool IsGoingBackward = false;
+		bool IsEmeraldVisible = false;
+
+		uint32_t BlueSpheres = 0;
+		uint32_t Rings = 0;
+		uint32_t CollectedRings = 0;
+		bool IsPerfect = false;
+
+		// Stage objects, (x, y) relative to the cell the player is in
+		std::array<EStageObject, WindowSize * WindowSize> Objects = {};
+
+		EStageObject GetValueAt(int32_t x, int32_t y) const
+		{
+			return Objects[size_t(y + s_SightRadius) * WindowSize + size_t(x + s_SightRadius)];
+		}
+	};
+
+	struct GameSimulationEvent
+	{
+		enum class EType : uint8_t
+		{
+			Action,
+			StateChanged
+		};
+
+		EType Type;
+		GameActionEvent Action;
+		GameStateChangedEvent StateChanged;
+	};
+
+	// Runs GameLogic at a fixed rate on its own thread, so that the simulation doesn't
+	// depend on the frame rate and a slow frame doesn't delay it. The render thread sends
+	// commands, reads the latest snapshot and drains the actions and state changes
+	class GameSimulation
+	{
+	public:
+		static constexpr float TickRate = 300.0f;
+
+		GameSimulation(const Ref<Stage>& stage, ESimulationMode mode = ESimulationMode::FixedStep);
+		GameSimulation(const GameSimulation&) = delete;
+		GameSimulation(GameSimulation&&) = delete;
+		~GameSimulation();
+
+		void Start();
+		void Stop();
+
+		void SetPaused(bool paused) { m_Paused.store(paused, std::memory_order_relaxed); }
+
+		// Render thread. The command is applied at the tick its timestamp falls in, or
+		// right away if that tick is already gone (GameLogic compensates for turns)
+		void Send(EGameCommand command, InputTimestamp timestamp = std::chrono::steady_clock::now());
+
+		// Render thread, returns false if no tick completed since the last call
+		bool UpdateSnapshot() { return m_Snapshots.Update(); }
+		const GameSnapshot& GetSnapshot() const { return m_Snapshots.GetReadBuffer(); }
+
+		// Render thread, in the order they happened
+		template<typename Fn>
+		void DrainEvents(Fn&& fn) { m_Events.Drain(std::forward<Fn>(fn)); }
+
+	private:
+		static constexpr size_t s_EventCapacity = 1024;
+
+		void Run();
+		void Tick(const Time& time, InputTimestamp tickEnd);
+		void FlushActions();
+		void SavePreviousTick();
+		void Publish();
+
+		Ref<Stage> m_Stage;
+		GameLogic m_GameLogic;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running = false;
+		std::atomic<bool> m_Paused = false;
+
+		SpscQueue<GameCommand, 64> m_Commands;
+		SpscQueue<GameSimulationEvent, s_EventCapacity> m_Events;
+		TripleBuffer<GameSnapshot> m_Snapshots;
+
+		// Simulation thread only
+		Time m_Time;
+		InputTimestamp m_ResumeTime = {};
+		InputTimestamp m_TickTime = {};
+		glm::vec2 m_TotalDeltaPosition = { 0.0f, 0.0f };
+		glm::vec2 m_PreviousPosition = { 0.0f, 0.0f }, m_PreviousTotalDeltaPosition = { 0.0f, 0.0f };
+		float m_PreviousRotationAngle = 0.0f, m_PreviousHeight = 0.0f;
+		uint32_t m_BlueSpheres = 0;
+		bool m_StageChanged = true;
+		Unsubscribe m_StateChangedSubscription;
+	};
+}
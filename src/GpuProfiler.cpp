@@ -0,0 +1,91 @@
+#include "BsfPch.h"
+
+#include "GpuProfiler.h"
+#include "Log.h"
+
+namespace bsf
+{
+	GpuProfiler& GpuProfiler::Get()
+	{
+		static GpuProfiler instance;
+		return instance;
+	}
+
+	void GpuProfiler::Initialize()
+	{
+		GLint bits = 0;
+		glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &bits);
+		glGetError(); // Ignore errors from implementations without timer queries
+
+		m_Supported = bits > 0;
+
+		if (!m_Supported)
+			BSF_WARN("GPU timer queries are not supported, GPU timings disabled");
+	}
+
+	void GpuProfiler::BeginFrame()
+	{
+		if (!m_Supported)
+			return;
+
+		m_Frame++;
+		const uint32_t slot = m_Frame % 2;
+
+		// Collect results of two frames ago
+		for (auto& scope : m_Scopes)
+		{
+			if (!scope.Pending[slot])
+				continue;
+
+			GLint available = GL_FALSE;
+			glGetQueryObjectiv(scope.Queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+
+			// Still in flight, the scope skips this frame
+			if (!available)
+				continue;
+
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(scope.Queries[slot], GL_QUERY_RESULT, &elapsed);
+
+			scope.Time = float(elapsed / 1e6);
+			scope.MeanTime = glm::mix(scope.MeanTime, scope.Time, 0.1f);
+			scope.Pending[slot] = false;
+		}
+	}
+
+	uint32_t GpuProfiler::Begin(const char* name)
+	{
+		if (!m_Supported || m_Active)
+			return None;
+
+		auto it = std::find_if(m_Scopes.begin(), m_Scopes.end(), [name](const Scope& s) { return s.Name == name; });
+
+		if (it == m_Scopes.end())
+		{
+			Scope scope;
+			scope.Name = name;
+			glGenQueries(GLsizei(scope.Queries.size()), scope.Queries.data());
+			m_Scopes.push_back(scope);
+			it = m_Scopes.end() - 1;
+		}
+
+		const uint32_t slot = m_Frame % 2;
+		if (it->Pending[slot])
+			return None;
+
+		glBeginQuery(GL_TIME_ELAPSED, it->Queries[slot]);
+		m_Active = true;
+
+		return uint32_t(std::distance(m_Scopes.begin(), it));
+	}
+
+	void GpuProfiler::End(uint32_t scope)
+	{
+		if (scope == None)
+			return;
+
+		glEndQuery(GL_TIME_ELAPSED);
+		m_Scopes[scope].Pending[m_Frame % 2] = true;
+		m_Active = false;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace bsf
+{
+	// Per-pass GPU times from GL_TIME_ELAPSED queries. Each scope has two sets of queries
+	// used on alternate frames, results are read one frame later and only if available,
+	// so the CPU never waits for the GPU. Scopes can't be nested.
+	// Disabled when the GL implementation has no timer (0 query counter bits)
+	class GpuProfiler
+	{
+	public:
+		struct Scope
+		{
+			const char* Name = nullptr;
+			std::array<uint32_t, 2> Queries = {};
+			std::array<bool, 2> Pending = {};
+			float Time = 0.0f;		// Milliseconds, last result
+			float MeanTime = 0.0f;	// Milliseconds, smoothed
+		};
+
+		static GpuProfiler& Get();
+
+		void Initialize();
+		void BeginFrame();
+
+		uint32_t Begin(const char* name);
+		void End(uint32_t scope);
+
+		bool IsSupported() const { return m_Supported; }
+		const std::vector<Scope>& GetScopes() const { return m_Scopes; }
+
+		static constexpr uint32_t None = ~0u;
+
+	private:
+		GpuProfiler() = default;
+
+		std::vector<Scope> m_Scopes;
+		uint32_t m_Frame = 0;
+		bool m_Supported = false;
+		bool m_Active = false;
+	};
+
+	struct GpuProfilerGuard
+	{
+	public:
+		GpuProfilerGuard(const char* name) : m_Scope(GpuProfiler::Get().Begin(name)) {}
+		~GpuProfilerGuard() { GpuProfiler::Get().End(m_Scope); }
+	private:
+		uint32_t m_Scope;
+	};
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bsf
+{
+	template<typename Signature, size_t Capacity = 48>
+	class InplaceFunction;
+
+	// Like std::function, but the callable is always stored inside the object itself.
+	// Callables that don't fit are a compile time error, so there's never an heap allocation
+	template<typename R, typename... Args, size_t Capacity>
+	class InplaceFunction<R(Args...), Capacity>
+	{
+	public:
+
+		InplaceFunction() = default;
+		InplaceFunction(std::nullptr_t) {}
+
+		template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+		InplaceFunction(F&& fn)
+		{
+			using Fn = std::decay_t<F>;
+
+			static_assert(sizeof(Fn) <= Capacity, "Callable is too big for this InplaceFunction");
+			static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable is over-aligned");
+
+			new (&m_Storage) Fn(std::forward<F>(fn));
+
+			m_Invoke = [](void* storage, Args... args) -> R {
+				return (*static_cast<Fn*>(storage))(std::forward<Args>(args)...);
+			};
+
+			m_Manage = [](void* dst, void* src, EOperation op) {
+				switch (op)
+				{
+				case EOperation::Copy: new (dst) Fn(*static_cast<const Fn*>(src)); break;
+				case EOperation::Move: new (dst) Fn(std::move(*static_cast<Fn*>(src))); break;
+				case EOperation::Destroy: static_cast<Fn*>(dst)->~Fn(); break;
+				}
+			};
+		}
+
+		InplaceFunction(const InplaceFunction& other) { CopyFrom(other); }
+		InplaceFunction(InplaceFunction&& other) noexcept { MoveFrom(std::move(other)); }
+
+		~InplaceFunction() { Reset(); }
+
+		InplaceFunction& operator=(const InplaceFunction& other)
+		{
+			if (this != &other)
+			{
+				Reset();
+				CopyFrom(other);
+			}
+			return *this;
+		}
+
+		InplaceFunction& operator=(InplaceFunction&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				MoveFrom(std::move(other));
+			}
+			return *this;
+		}
+
+		InplaceFunction& operator=(std::nullptr_t) { Reset(); return *this; }
+
+		R operator()(Args... args) const { return m_Invoke(&m_Storage, std::forward<Args>(args)...); }
+
+		explicit operator bool() const { return m_Invoke != nullptr; }
+
+		friend bool operator==(const InplaceFunction& f, std::nullptr_t) { return !f; }
+		friend bool operator!=(const InplaceFunction& f, std::nullptr_t) { return (bool)f; }
+
+		void Reset()
+		{
+			if (m_Manage)
+				m_Manage(&m_Storage, nullptr, EOperation::Destroy);
+			m_Invoke = nullptr;
+			m_Manage = nullptr;
+		}
+
+	private:
+
+		enum class EOperation { Copy, Move, Destroy };
+
+		using InvokeFnPtr = R(*)(void*, Args...);
+		using ManageFnPtr = void(*)(void*, void*, EOperation);
+
+		void CopyFrom(const InplaceFunction& other)
+		{
+			if (other.m_Manage)
+				other.m_Manage(&m_Storage, &other.m_Storage, EOperation::Copy);
+			m_Invoke = other.m_Invoke;
+			m_Manage = other.m_Manage;
+		}
+
+		void MoveFrom(InplaceFunction&& other)
+		{
+			if (other.m_Manage)
+				other.m_Manage(&m_Storage, &other.m_Storage, EOperation::Move);
+			m_Invoke = other.m_Invoke;
+			m_Manage = other.m_Manage;
+			other.Reset();
+		}
+
+		mutable std::aligned_storage_t<Capacity, alignof(std::max_align_t)> m_Storage;
+		InvokeFnPtr m_Invoke = nullptr;
+		ManageFnPtr m_Manage = nullptr;
+	};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "EventEmitter.h"
+
+#include <variant>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace bsf
+{
+	struct InputEvent
+	{
+		enum class EType : uint8_t
+		{
+			KeyPressed,
+			KeyReleased,
+			CharacterTyped,
+			MousePressed,
+			MouseReleased,
+			MouseMoved,
+			Wheel,
+			WindowResized
+		};
+
+		EType Type;
+		std::variant<KeyPressedEvent, KeyReleasedEvent, CharacterTypedEvent, MouseEvent, WheelEvent, WindowResizedEvent> Data;
+	};
+
+	// Input received from the window callbacks, in order and with the time it was received.
+	// The application drains it at the beginning of the frame, before the scene update, so
+	// that no handler runs in the middle of the event polling.
+	// Consecutive cursor moves are coalesced into one event with the latest position and the
+	// accumulated deltas. The single samples are kept only if asked with SetKeepRawMouseMoves
+	class InputQueue
+	{
+	public:
+		void Push(const InputEvent& evt)
+		{
+			if (evt.Type != InputEvent::EType::MouseMoved)
+			{
+				m_Events.push_back(evt);
+				return;
+			}
+
+			MouseEvent move = std::get<MouseEvent>(evt.Data);
+
+			if (m_HasCursorPosition)
+			{
+				move.DeltaX = move.X - m_CursorPosition.x;
+				move.DeltaY = move.Y - m_CursorPosition.y;
+			}
+
+			m_CursorPosition = { move.X, move.Y };
+			m_HasCursorPosition = true;
+
+			if (m_KeepRawMouseMoves)
+				m_RawMouseMoves.push_back(move);
+
+			if (!m_Events.empty() && m_Events.back().Type == InputEvent::EType::MouseMoved)
+			{
+				auto& last = std::get<MouseEvent>(m_Events.back().Data);
+				last.X = move.X;
+				last.Y = move.Y;
+				last.DeltaX += move.DeltaX;
+				last.DeltaY += move.DeltaY;
+				last.Timestamp = move.Timestamp;
+			}
+			else
+			{
+				m_Events.push_back({ InputEvent::EType::MouseMoved, move });
+			}
+		}
+
+		template<typename Fn>
+		void Drain(Fn&& fn)
+		{
+			// Handlers can't push new input, but let's not depend on it
+			for (size_t i = 0; i < m_Events.size(); i++)
+				fn(m_Events[i]);
+
+			m_Events.clear();
+		}
+
+		template<typename Fn>
+		void DrainRawMouseMoves(Fn&& fn)
+		{
+			for (size_t i = 0; i < m_RawMouseMoves.size(); i++)
+				fn(m_RawMouseMoves[i]);
+
+			m_RawMouseMoves.clear();
+		}
+
+		void SetKeepRawMouseMoves(bool keep) { m_KeepRawMouseMoves = keep; }
+
+		bool Empty() const { return m_Events.empty(); }
+
+	private:
+		std::vector<InputEvent> m_Events;
+		std::vector<MouseEvent> m_RawMouseMoves;
+		glm::vec2 m_CursorPosition = { 0.0f, 0.0f };
+		bool m_HasCursorPosition = false;
+		bool m_KeepRawMouseMoves = false;
+	};
+}
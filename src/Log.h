@@ -2,6 +2,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include "GLStats.h"
+
 #define BSF_LOG_INIT() ::bsf::InitializeFileLog()
 
 #define BSF_DEBUG(...) SPDLOG_DEBUG(__VA_ARGS__)
@@ -11,7 +13,7 @@
 
 
 #ifdef BSF_SAFE_GLCALL
-#define BSF_GLCALL(x) (x); if(auto err = glGetError(); err != GL_NO_ERROR) BSF_ERROR("OpenGL Error ({0})", err)
+#define BSF_GLCALL(x) (x); BSF_GLSTAT(GLCalls); if(auto err = glGetError(); err != GL_NO_ERROR) BSF_ERROR("OpenGL Error ({0})", err)
 #else
 #define BSF_GLCALL(x) (x)
 #endif
@@ -9,10 +9,16 @@
 
 namespace bsf
 {
-	void Run()
+	void Run(int argc, char** argv)
 	{
 		auto scene = Ref<Scene>(new DisclaimerScene());
 		Application app;
+
+		// --trace <file>: write a Chrome trace of the session
+		for (int i = 1; i + 1 < argc; i++)
+			if (std::string_view(argv[i]) == "--trace")
+				app.SetTraceFile(argv[i + 1]);
+
 		app.GotoScene(std::move(scene));
 		app.Start();
 	}
@@ -22,6 +28,6 @@ namespace bsf
 
 int main(int argc, char** argv)
 {
-	bsf::Run();
+	bsf::Run(argc, argv);
 	return 0;
 }
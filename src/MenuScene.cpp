@@ -118,7 +118,7 @@ namespace bsf
 		BuildMenus();
 
 		// Fade In
-		ScheduleTask(ESceneTaskEvent::PostRender, MakeRef<FadeTask>(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f }, glm::vec4{ 1.0f, 1.0f, 1.0f, 0.0f }, 0.5f));
+		ScheduleTask(ESceneTaskEvent::PostRender, CreateTask<FadeTask>(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f }, glm::vec4{ 1.0f, 1.0f, 1.0f, 0.0f }, 0.5f));
 
 	}
 
@@ -230,9 +230,13 @@ namespace bsf
 
 		m_DisplayModeMenuItem = optionsMenu->AddItem<SelectMenuItem<DisplayModeDescriptor>>("Display Mode");
 		m_FullscreenMenuItem = optionsMenu->AddItem<SelectMenuItem<bool>>("Fullscreen");
+		m_VSyncMenuItem = optionsMenu->AddItem<SelectMenuItem<bool>>("VSync");
+		m_FrameRateLimitMenuItem = optionsMenu->AddItem<SelectMenuItem<uint32_t>>("Frame Limit");
 		optionsMenu->AddItem<ButtonMenuItem>("Back")->SetConfirmFunction([&](MenuRoot& root) {
 			m_Config.DisplayMode = m_DisplayModeMenuItem->GetSelectedOption();
 			m_Config.Fullscreen = m_FullscreenMenuItem->GetSelectedOption();
+			m_Config.VSync = m_VSyncMenuItem->GetSelectedOption();
+			m_Config.FrameRateLimit = m_FrameRateLimitMenuItem->GetSelectedOption();
 			m_Config.Save();
 			GetApplication().LoadConfig();
 			root.PopMenu();
@@ -244,6 +248,22 @@ namespace bsf
 
 		m_FullscreenMenuItem->SetSelectedOption(m_Config.Fullscreen);
 
+		m_VSyncMenuItem->AddOption("Yes", true);
+		m_VSyncMenuItem->AddOption("No", false);
+		m_VSyncMenuItem->SetSelectedOption(m_Config.VSync);
+
+		constexpr std::array<uint32_t, 4> frameRates = { 30, 60, 120, 144 };
+
+		m_FrameRateLimitMenuItem->AddOption("Off", 0);
+		for (uint32_t fps : frameRates)
+			m_FrameRateLimitMenuItem->AddOption(std::to_string(fps), fps);
+
+		// Keep custom values from the config file
+		const uint32_t frameRateLimit = m_Config.FrameRateLimit;
+		if (frameRateLimit != 0 && std::find(frameRates.begin(), frameRates.end(), frameRateLimit) == frameRates.end())
+			m_FrameRateLimitMenuItem->AddOption(std::to_string(frameRateLimit), frameRateLimit);
+		m_FrameRateLimitMenuItem->SetSelectedOption(m_Config.FrameRateLimit);
+
 		for (auto& mode : GetDisplayModes())
 			m_DisplayModeMenuItem->AddOption(mode.ToString(), mode);
 
@@ -290,7 +310,7 @@ namespace bsf
 
 	void MenuScene::PlayStage(const Ref<Stage>& stage, const GameInfo& gameInfo)
 	{
-		auto fadeTask = MakeRef<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 0.5f);
+		auto fadeTask = CreateTask<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 0.5f);
 
 
 		fadeTask->SetDoneFunction([&, stage, gameInfo](SceneTask& self) {
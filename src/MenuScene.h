@@ -208,6 +208,8 @@ namespace bsf
 		Ref<SelectMenuItem<std::string>> m_SelectStageMenuItem;
 		Ref<SelectMenuItem<DisplayModeDescriptor>> m_DisplayModeMenuItem;
 		Ref<SelectMenuItem<bool>> m_FullscreenMenuItem;
+		Ref<SelectMenuItem<bool>> m_VSyncMenuItem;
+		Ref<SelectMenuItem<uint32_t>> m_FrameRateLimitMenuItem;
 		Ref<StageCodeMenuItem> m_StageCodeMenuItem;
 		Ref<Texture2D> m_txBackground;
 
@@ -9,8 +9,15 @@
 #include "Font.h"
 #include "Diagnostic.h"
 
-static constexpr uint32_t s_MaxTriangleVertices = 30000 * 3;
+static constexpr uint32_t s_MaxQuads = 20000;
+static constexpr uint32_t s_MaxQuadVertices = s_MaxQuads * 4;
+static constexpr uint32_t s_MaxQuadIndices = s_MaxQuads * 6;
+static constexpr uint32_t s_StreamVertices = s_MaxQuadVertices * 2; // Ring of batches
+static constexpr uint32_t s_MinBatchQuads = 1024; // Less than this left in the ring, start over
 static constexpr uint32_t s_MaxTextureUnits = 32;
+static constexpr uint32_t s_MaxClipRects = 32; // Including the "no clip" slot
+static constexpr size_t s_MaxTextLayouts = 1024; // Past this, layouts not used recently are evicted
+static constexpr uint32_t s_TextLayoutLifetime = 60; // In calls to Begin
 
 #pragma region Shaders Code
 
@@ -19,13 +26,12 @@ static const std::string s_VertexSource = R"VERTEX(
 	#version 330
 
 	uniform mat4 uProjection;
+	uniform vec4 uClipRects[32];
 
 	layout(location = 0) in vec2 aPosition;
 	layout(location = 1) in vec2 aUv;
 	layout(location = 2) in vec4 aColor;
-	layout(location = 3) in uint aTexture;
-	layout(location = 4) in uint aClip;
-	layout(location = 5) in vec4 aClipPlanes;
+	layout(location = 3) in uvec2 aTextureClip;
 
 	out vec2 fPosition;
 	out vec2 fUv;
@@ -39,9 +45,9 @@ static const std::string s_VertexSource = R"VERTEX(
 		fPosition = aPosition;
 		fUv = aUv;
 		fColor = aColor;
-		fTexture = aTexture;
-		fClip = aClip;
-		fClipPlanes = aClipPlanes;
+		fTexture = aTextureClip.x;
+		fClip = aTextureClip.y;
+		fClipPlanes = uClipRects[aTextureClip.y];
 	}
 
 )VERTEX";
@@ -107,6 +113,33 @@ static const std::string s_FragmentSource = R"FRAGMENT(
 		}
 	}
 
+)FRAGMENT";
+
+// Used when the batch has a single texture (usually an atlas page). Quads without texture
+// sample it too and discard the result, so there are no branches on the texture slot
+static const std::string s_SingleSamplerFragmentSource = R"FRAGMENT(
+
+	#version 330
+
+	uniform sampler2D uTexture;
+
+	in vec2 fPosition;
+	in vec2 fUv;
+	in vec4 fColor;
+	flat in uint fTexture;
+	flat in uint fClip;
+	flat in vec4 fClipPlanes;
+
+	out vec4 oColor;
+
+	void main() {
+
+		if(fClip > 0u && (fPosition.x < fClipPlanes.x || fPosition.x > fClipPlanes.y || fPosition.y < fClipPlanes.z || fPosition.y > fClipPlanes.w))
+			discard;
+		else
+			oColor = fColor * mix(vec4(1.0), texture(uTexture, fUv), float(fTexture != 0u));
+	}
+
 )FRAGMENT";
 #pragma endregion
 
@@ -114,8 +147,11 @@ namespace bsf
 {
 
 	Renderer2D::Renderer2D() :
-		m_TriangleVertices(nullptr),
-		m_CurVertexIndex(0),
+		m_QuadVertices(nullptr),
+		m_QuadCount(0),
+		m_BatchCapacity(0),
+		m_BatchStart(0),
+		m_StreamOffset(0),
 		m_Projection(glm::identity<glm::mat4>())
 	{
 		Initialize();
@@ -123,27 +159,39 @@ namespace bsf
 
 	Renderer2D::~Renderer2D()
 	{
-		delete[] m_TriangleVertices;
+		if (m_QuadVertices != nullptr)
+			m_Quads->GetVertexBuffer(0)->Unmap();
 	}
 
 	void Renderer2D::Initialize()
 	{
 
 		// Init Vertex Arrays
-		m_TriangleVertices = new Vertex2D[s_MaxTriangleVertices];
-
-		auto trianglesVb = Ref<VertexBuffer>(new VertexBuffer({
+		auto quadsVb = Ref<VertexBuffer>(new VertexBuffer({
 			{ "aPosition", AttributeType::Float2  },
 			{ "aUv", AttributeType::Float2  },
 			{ "aColor", AttributeType::Float4  },
-			{ "aTexture", AttributeType::UInt  },
-			{ "aClip", AttributeType::UInt },
-			{ "aClipPlanes", AttributeType::Float4},
-		}, nullptr, s_MaxTriangleVertices, GL_DYNAMIC_DRAW));
+			{ "aTextureClip", AttributeType::UShort2 },
+		}, nullptr, s_StreamVertices, GL_STREAM_DRAW));
+
+		// Every quad is two triangles sharing the diagonal, so the index buffer never changes
+		std::vector<uint32_t> indices(s_MaxQuadIndices);
 
-		m_Triangles = Ref<VertexArray>(new VertexArray(s_MaxTriangleVertices, { trianglesVb }));
+		for (uint32_t i = 0; i < s_MaxQuads; i++)
+		{
+			const uint32_t v = i * 4;
+			std::array<uint32_t, 6> quad = { v, v + 1, v + 2, v, v + 2, v + 3 };
+			std::copy(quad.begin(), quad.end(), indices.begin() + size_t(i) * 6);
+		}
 
-		m_pTriangleProgram = MakeRef<ShaderProgram>(s_VertexSource, s_FragmentSource);
+		m_Quads = Ref<VertexArray>(new VertexArray(s_StreamVertices, { quadsVb }));
+		m_Quads->SetIndexBuffer(MakeRef<IndexBuffer>(indices.data(), AttributeType::UInt, indices.size()));
+
+		m_pQuadProgram = MakeRef<ShaderProgram>(s_VertexSource, s_FragmentSource);
+		m_pSingleSamplerProgram = MakeRef<ShaderProgram>(s_VertexSource, s_SingleSamplerFragmentSource);
+
+		m_ClipRects.reserve(s_MaxClipRects);
+		m_ClipRects.push_back(glm::vec4(0.0f));
 
 		m_Textures.resize(s_MaxTextureUnits);
 
@@ -163,72 +211,139 @@ namespace bsf
 
 		// Projection matrix
 		m_Projection = projection;
+
+		m_TextTick++;
 	}
 
-	void Renderer2D::DrawTriangleInternal(const std::array<glm::vec2, 3>& positions, const std::array<glm::vec2, 3>& uvs)
+	uint16_t Renderer2D::FindTextureSlot(const Ref<Texture2D>& texture)
 	{
-		BSF_DIAGNOSTIC_FUNC();
+		if (texture == nullptr)
+			return 0;
 
-		const auto& state = m_State.top();
-
-		uint32_t textureIndex = 0;
+		const auto begin = m_Textures.begin() + 1, end = m_Textures.begin() + m_TextureCount;
+		auto cached = std::find(begin, end, texture->GetId());
 
-		if (state.CurrentTexture != nullptr)
+		if (cached == end) // texture not in this batch, take the next slot
 		{
+			if (m_TextureCount == s_MaxTextureUnits) // Too many textures, need to flush
+				End();
 
-			auto cached = std::find(m_Textures.begin(), m_Textures.end(), state.CurrentTexture->GetId());
+			m_Textures[m_TextureCount] = texture->GetId();
+			return uint16_t(m_TextureCount++);
+		}
 
-			if (cached == m_Textures.end()) // texture not cached, try to find empty slot
-			{
-				auto tex = std::find(m_Textures.begin(), m_Textures.end(), 0);
+		return uint16_t(cached - m_Textures.begin());
+	}
 
-				if (tex == m_Textures.end()) // Too many textures, need to flush
-				{
-					End();
-					tex = m_Textures.begin() + 1;
-				}
+	uint16_t Renderer2D::GetTextureSlot(Renderer2DState& state)
+	{
+		// Slots are valid until the batch is flushed, so the search runs once per
+		// batch and texture change instead of once per quad
+		if (state.TextureGeneration != m_BatchGeneration)
+		{
+			state.TextureSlot = FindTextureSlot(state.CurrentTexture);
+			state.TextureGeneration = m_BatchGeneration;
+		}
 
-				*tex = state.CurrentTexture->GetId();
+		return state.TextureSlot;
+	}
 
-				cached = tex;
+	uint16_t Renderer2D::GetClipIndex(const std::optional<Rect>& clip)
+	{
+		if (!clip.has_value())
+			return 0;
 
-			}
+		const glm::vec4 planes = (glm::vec4)clip.value();
 
-			textureIndex = cached - m_Textures.begin();
+		// Consecutive quads almost always share the clip rect
+		if (m_ClipRects[m_LastClipIndex] == planes && m_LastClipIndex != 0)
+			return m_LastClipIndex;
 
+		auto cached = std::find(m_ClipRects.begin() + 1, m_ClipRects.end(), planes);
+
+		if (cached == m_ClipRects.end())
+		{
+			if (m_ClipRects.size() == s_MaxClipRects) // Too many clip rects, need to flush
+				End();
+
+			m_ClipRects.push_back(planes);
+			cached = m_ClipRects.end() - 1;
 		}
 
+		m_LastClipIndex = uint16_t(cached - m_ClipRects.begin());
+		return m_LastClipIndex;
+	}
+
+	void Renderer2D::DrawQuadInternal(const std::array<glm::vec2, 4>& positions, const std::array<glm::vec2, 4>& uvs)
+	{
+		const auto& state = m_State.top();
+		DrawQuadInternal(state.Transform, state.Color, positions, uvs);
+	}
+
+	void Renderer2D::DrawQuadInternal(const Affine2D& transform, const glm::vec4& color, const std::array<glm::vec2, 4>& positions, const std::array<glm::vec2, 4>& uvs)
+	{
+		BSF_DIAGNOSTIC_FUNC();
+
+		auto& state = m_State.top();
+
+		// Both might flush the batch, so they go before writing the vertices
+		uint16_t textureSlot = GetTextureSlot(state);
+		const uint16_t clipIndex = GetClipIndex(state.Clip);
 
-		Triangle2D transformed;
+		// The clip rects were full and the batch has been flushed, along with the textures
+		if (state.TextureGeneration != m_BatchGeneration)
+			textureSlot = GetTextureSlot(state);
+
+		if (m_QuadVertices == nullptr && !BeginBatch())
+			return;
+
+		std::array<glm::vec2, 4> transformed;
+		TransformPoints4(transform, positions.data(), transformed.data());
+
+		// Built locally and copied whole, the mapped memory is write combined
+		std::array<Vertex2D, 4> vertices;
 
 		for (size_t i = 0; i < positions.size(); i++)
 		{
-			auto worldPos = state.Matrix * glm::vec4(positions[i].x, positions[i].y, 0.0f, 1.0f);
+			vertices[i].Postion = transformed[i];
+			vertices[i].UV = uvs[i] * state.UvScale + state.UvOffset;
+			vertices[i].Color = color;
+			vertices[i].TextureSlot = textureSlot;
+			vertices[i].ClipIndex = clipIndex;
+		}
 
-			transformed[i].Postion = { worldPos.x, worldPos.y };
-			transformed[i].UV = uvs[i];
-			transformed[i].Color = m_State.top().Color;
-			transformed[i].TextureID = textureIndex;
+		std::memcpy(&m_QuadVertices[m_QuadCount * 4], vertices.data(), sizeof(vertices));
 
-			if (state.Clip.has_value())
-			{
-				transformed[i].Clip = true;
-				transformed[i].ClipPlanes = (glm::vec4)state.Clip.value();
-			}
-			else
-			{
-				transformed[i].Clip = false;
-			}
+		if (++m_QuadCount == m_BatchCapacity)
+			End();
 
+	}
 
+	bool Renderer2D::BeginBatch()
+	{
+		// Batches are written straight into the vertex buffer, one after the other. The GPU
+		// might still be reading the previous ones, but they are never written again, so the
+		// mapping doesn't need to wait. When the ring is over the buffer is orphaned: the
+		// driver gives us new storage and frees the old one when the GPU is done with it
+		GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+
+		if (s_StreamVertices - m_StreamOffset < s_MinBatchQuads * 4)
+		{
+			m_StreamOffset = 0;
+			access |= GL_MAP_INVALIDATE_BUFFER_BIT;
 		}
 
-		std::memcpy((void*)&m_TriangleVertices[m_CurVertexIndex], (void*)transformed.data(), transformed.size() * sizeof(Vertex2D));
-		m_CurVertexIndex += transformed.size();
+		m_BatchStart = m_StreamOffset;
+		m_BatchCapacity = std::min<size_t>(s_MaxQuads, (s_StreamVertices - m_StreamOffset) / 4);
+		m_QuadVertices = static_cast<Vertex2D*>(m_Quads->GetVertexBuffer(0)->MapRange(m_BatchStart, uint32_t(m_BatchCapacity * 4), access));
 
-		if (m_CurVertexIndex == s_MaxTriangleVertices)
-			End();
+		if (m_QuadVertices == nullptr)
+		{
+			BSF_ERROR("Can't map the Renderer2D vertex buffer");
+			return false;
+		}
 
+		return true;
 	}
 
 	void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec2& uvSize, const glm::vec2& uvOffset)
@@ -251,101 +366,169 @@ namespace bsf
 			glm::vec2{ uvOffset.x + 0.0f,		uvOffset.y + uvSize.y	}
 		};
 
-		DrawTriangleInternal({ positions[0], positions[1], positions[2] }, { uvs[0], uvs[1], uvs[2] });
-		DrawTriangleInternal({ positions[0], positions[2], positions[3] }, { uvs[0], uvs[2], uvs[3] });
+		DrawQuadInternal(positions, uvs);
 
 	}
 
-	void Renderer2D::DrawString(const Ref<Font>& font, const FormattedString& str, const glm::vec2& position)
+	const Renderer2D::TextLayout& Renderer2D::GetTextLayout(const Ref<Font>& font, const FormattedString& str)
 	{
-		static std::array<glm::vec2, 4> pos, uvs = {};
+		BSF_DIAGNOSTIC_FUNC();
 
-		float strWidth = font->GetStringWidth(str.GetPlainText());
+		const auto text = str.GetPlainText();
+		const auto& runs = str.GetColorRuns();
 
-		Push();
+		size_t hash = std::hash<std::string_view>()(text) ^ std::hash<const Font*>()(font.get());
+		for (const auto& run : runs)
+		{
+			const auto c = run.Color.value_or(glm::vec4(-1.0f));
+			hash = hash * 31 + (run.Begin ^ std::hash<float>()(c.r + c.g * 3.0f + c.b * 7.0f + c.a * 11.0f));
+		}
 
-		Texture(font->GetTexture());
+		const auto matches = [&](const TextLayout& layout) {
+			return layout.LayoutFont == font.get() && layout.Text == text &&
+				std::equal(layout.ColorRuns.begin(), layout.ColorRuns.end(), runs.begin(), runs.end());
+		};
 
-		float offsetX = position.x - m_State.top().Pivot.x * strWidth;
-		float offsetY = position.y - m_State.top().Pivot.y;
+		auto [begin, end] = m_TextLayouts.equal_range(hash);
+		for (auto it = begin; it != end; ++it)
+		{
+			if (matches(it->second))
+			{
+				it->second.LastUsed = m_TextTick;
+				return it->second;
+			}
+		}
 
-		for (uint32_t i = 0; i < str.Size(); ++i)
+		// Evict what hasn't been drawn for a while (counters, timers...)
+		if (m_TextLayouts.size() >= s_MaxTextLayouts)
 		{
-			if (str[i].Color.has_value())
-				Color(str[i].Color.value());
-			else
-				Color(m_State.top().Color);
+			std::erase_if(m_TextLayouts, [&](const auto& entry) { return m_TextTick - entry.second.LastUsed > s_TextLayoutLifetime; });
 
-			const auto& glyph = font->GetGlyphInfo(str[i].Code);
+			if (m_TextLayouts.size() >= s_MaxTextLayouts)
+				m_TextLayouts.clear();
+		}
 
-			pos[0] = { offsetX + glyph.Min.x, offsetY + glyph.Min.y };
-			pos[1] = { offsetX + glyph.Max.x, offsetY + glyph.Min.y };
-			pos[2] = { offsetX + glyph.Max.x, offsetY + glyph.Max.y };
-			pos[3] = { offsetX + glyph.Min.x, offsetY + glyph.Max.y };
+		TextLayout layout;
+		layout.LayoutFont = font.get();
+		layout.Text = text;
+		layout.ColorRuns.assign(runs.begin(), runs.end());
+		layout.Glyphs.resize(str.Size());
+		layout.LastUsed = m_TextTick;
 
+		float offsetX = 0.0f;
 
-			uvs[0] = { glyph.UvMin.x, glyph.UvMin.y };
-			uvs[1] = { glyph.UvMax.x, glyph.UvMin.y };
-			uvs[2] = { glyph.UvMax.x, glyph.UvMax.y };
-			uvs[3] = { glyph.UvMin.x, glyph.UvMax.y };
+		for (size_t i = 0; i < str.Size(); ++i)
+		{
+			const auto& glyph = font->GetGlyphInfo(text[i]);
+			auto& quad = layout.Glyphs[i];
 
+			quad.Positions[0] = { offsetX + glyph.Min.x, glyph.Min.y };
+			quad.Positions[1] = { offsetX + glyph.Max.x, glyph.Min.y };
+			quad.Positions[2] = { offsetX + glyph.Max.x, glyph.Max.y };
+			quad.Positions[3] = { offsetX + glyph.Min.x, glyph.Max.y };
 
-			DrawTriangleInternal({ pos[0], pos[1], pos[2] }, { uvs[0], uvs[1], uvs[2] });
-			DrawTriangleInternal({ pos[0], pos[2], pos[3] }, { uvs[0], uvs[2], uvs[3] });
+			quad.UVs[0] = { glyph.UvMin.x, glyph.UvMin.y };
+			quad.UVs[1] = { glyph.UvMax.x, glyph.UvMin.y };
+			quad.UVs[2] = { glyph.UvMax.x, glyph.UvMax.y };
+			quad.UVs[3] = { glyph.UvMin.x, glyph.UvMax.y };
 
 			offsetX += glyph.Advance;
-
 		}
 
-		Pop();
+		// Only the first glyph of a run sets the color, the following ones keep it
+		for (const auto& run : runs)
+			if (run.Begin < layout.Glyphs.size())
+				layout.Glyphs[run.Begin].Color = run.Color;
+
+		layout.Width = offsetX;
+
+		return m_TextLayouts.emplace(hash, std::move(layout))->second;
 	}
 
-	void Renderer2D::DrawStringShadow(const Ref<Font>& font, const FormattedString& str, const glm::vec2& position)
+	void Renderer2D::DrawTextLayout(const Ref<Font>& font, const TextLayout& layout, const glm::vec2& position, const std::optional<glm::vec4>& color)
 	{
+		Push();
+
+		Texture(font->GetTexture());
 
 		const auto& state = m_State.top();
-		Push();
-		Color(state.TextShadowColor);
-		// Draw the shadow (no color/formatting)
-		DrawString(font, str.GetPlainText(), position + state.TextShadowOffset);
+
+		// The pivot moves the whole string, the layout is relative to its start
+		Affine2D transform = state.Transform;
+		transform.Translate(position - state.Pivot * glm::vec2(layout.Width, 1.0f));
+
+		// Characters without a color keep the last one, starting with the current color
+		glm::vec4 currentColor = color.value_or(state.Color);
+
+		for (const auto& glyph : layout.Glyphs)
+		{
+			if (glyph.Color.has_value() && !color.has_value())
+				currentColor = glyph.Color.value();
+
+			DrawQuadInternal(transform, currentColor, glyph.Positions, glyph.UVs);
+		}
+
 		Pop();
+	}
 
-		DrawString(font, str, position);
+	void Renderer2D::DrawString(const Ref<Font>& font, const FormattedString& str, const glm::vec2& position)
+	{
+		DrawTextLayout(font, GetTextLayout(font, str), position, std::nullopt);
+	}
+
+	void Renderer2D::DrawStringShadow(const Ref<Font>& font, const FormattedString& str, const glm::vec2& position)
+	{
+		const auto& state = m_State.top();
+		const auto& layout = GetTextLayout(font, str);
 
+		// The shadow has no color/formatting
+		DrawTextLayout(font, layout, position + state.TextShadowOffset, state.TextShadowColor);
+		DrawTextLayout(font, layout, position, std::nullopt);
 	}
 
 
 	void Renderer2D::LoadIdentity()
 	{
-		m_State.top().Matrix = glm::identity<glm::mat4>();
+		m_State.top().Transform = {};
 	}
 
 	void Renderer2D::Scale(const glm::vec2& scale)
 	{
-		auto& matrix = m_State.top().Matrix;
-		matrix = glm::scale(matrix, { scale.x, scale.y, 1.0f });
+		m_State.top().Transform.Scale(scale);
 	}
 
 	void Renderer2D::Translate(const glm::vec2& translate)
 	{
-		auto& matrix = m_State.top().Matrix;
-		matrix = glm::translate(matrix, { translate.x, translate.y, 0.0f });
+		m_State.top().Transform.Translate(translate);
 	}
 
 	void Renderer2D::Rotate(float angle)
 	{
-		auto& matrix = m_State.top().Matrix;
-		matrix = glm::rotate(matrix, angle, { 0.0f, 0.0f, 1.0f });
+		m_State.top().Transform.Rotate(angle);
 	}
 
 	void Renderer2D::Texture(const Ref<::bsf::Texture2D>& texture)
 	{
-		m_State.top().CurrentTexture = texture;
+		auto& state = m_State.top();
+
+		if (state.CurrentTexture == texture)
+			return;
+
+		state.CurrentTexture = texture;
+		state.TextureGeneration = 0;
+		state.UvOffset = texture ? texture->GetUvOffset() : glm::vec2(0.0f);
+		state.UvScale = texture ? texture->GetUvScale() : glm::vec2(1.0f);
+		GetTextureSlot(state);
 	}
 
 	void Renderer2D::NoTexture()
 	{
-		m_State.top().CurrentTexture = nullptr;
+		auto& state = m_State.top();
+		state.CurrentTexture = nullptr;
+		state.TextureSlot = 0;
+		state.TextureGeneration = m_BatchGeneration;
+		state.UvOffset = { 0.0f, 0.0f };
+		state.UvScale = { 1.0f, 1.0f };
 	}
 
 	void Renderer2D::Pivot(EPivot mode)
@@ -420,8 +603,21 @@ namespace bsf
 	void Renderer2D::End()
 	{
 
-		// Flush Triangles
-		if (m_CurVertexIndex > 0)
+		// Close the batch
+		if (m_QuadVertices != nullptr)
+		{
+			auto& vb = m_Quads->GetVertexBuffer(0);
+
+			if (m_QuadCount > 0)
+				vb->FlushMappedRange(0, uint32_t(m_QuadCount * 4));
+
+			vb->Unmap();
+			m_QuadVertices = nullptr;
+			m_StreamOffset += uint32_t(m_QuadCount * 4);
+		}
+
+		// Flush quads
+		if (m_QuadCount > 0)
 		{
 			BSF_DIAGNOSTIC_FUNC();
 
@@ -433,55 +629,84 @@ namespace bsf
 			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 
-			m_pTriangleProgram->Use();
+			// Slot 0 is the white texture, the single sampler path can do without it
+			const bool singleSampler = m_SingleSamplerPath && m_TextureCount <= 2;
+			auto& program = singleSampler ? m_pSingleSamplerProgram : m_pQuadProgram;
+
+			program->Use();
 
-			m_pTriangleProgram->UniformMatrix4f(HS("uProjection"), m_Projection);
+			program->UniformMatrix4f(HS("uProjection"), m_Projection);
+			program->Uniform4fv(HS("uClipRects[0]"), (uint32_t)m_ClipRects.size(), glm::value_ptr(m_ClipRects[0]));
 
-			for (uint32_t i = 0; i < m_Textures.size(); i++)
+			if (singleSampler)
 			{
-				BSF_GLCALL(glActiveTexture(GL_TEXTURE0 + i));
-				BSF_GLCALL(glBindTexture(GL_TEXTURE_2D, m_Textures[i]));
-			}
+				BSF_GLSTAT(TextureBinds);
+				BSF_GLCALL(glActiveTexture(GL_TEXTURE0));
+				BSF_GLCALL(glBindTexture(GL_TEXTURE_2D, m_Textures[m_TextureCount - 1]));
 
-			m_pTriangleProgram->Uniform1iv(HS("uTextures[0]"), (uint32_t)m_Textures.size(), m_TextureUnits.data());
+				program->Uniform1i(HS("uTexture"), { 0 });
+			}
+			else
+			{
+				for (uint32_t i = 0; i < m_Textures.size(); i++)
+				{
+					BSF_GLSTAT(TextureBinds);
+					BSF_GLCALL(glActiveTexture(GL_TEXTURE0 + i));
+					BSF_GLCALL(glBindTexture(GL_TEXTURE_2D, m_Textures[i]));
+				}
 
-			m_Triangles->GetVertexBuffer(0)->SetSubData(m_TriangleVertices, 0, m_CurVertexIndex);
+				program->Uniform1iv(HS("uTextures[0]"), (uint32_t)m_Textures.size(), m_TextureUnits.data());
+			}
 
-			m_Triangles->DrawArrays(GL_TRIANGLES, m_CurVertexIndex);
+			m_Quads->DrawIndexed(GL_TRIANGLES, uint32_t(m_QuadCount * 6), int32_t(m_BatchStart));
 
-			m_CurVertexIndex = 0;
+			m_QuadCount = 0;
 
 
 		}
 
+		// Reset clip rects
+		m_ClipRects.resize(1);
+		m_LastClipIndex = 0;
+
 		// Reset Textures
 		std::memset(m_Textures.data(), 0, m_Textures.size() * sizeof(uint32_t));
 		m_Textures[0] = Assets::GetInstance().Get<Texture2D>(AssetName::TexWhite)->GetId();
+		m_TextureCount = 1;
+
+		// Invalidates the texture slots cached on the states
+		m_BatchGeneration++;
 
 	}
-	FormattedString::FormattedString(const char* ch) : FormattedString(std::string(ch))
-	{
-	}
-	FormattedString::FormattedString(const std::string& str)
+	FormattedString::FormattedString(std::string_view str)
 	{
 		Add(str);
 	}
+
 	FormattedString& FormattedString::Color(const glm::vec4& color)
 	{
 		m_CurrentColor = color;
 		return *this;
 	}
+
 	FormattedString& FormattedString::ResetColor()
 	{
 		m_CurrentColor.reset();
 		return *this;
 	}
 
-	FormattedString& FormattedString::Add(const std::string& str)
+	FormattedString& FormattedString::Add(std::string_view str)
 	{
-		m_PlainText += str;
-		for (auto c : str)
-			m_Characters.push_back({ c, m_CurrentColor });
+		if (str.empty())
+			return *this;
+
+		// A new run only when the color changes, the text starts without color
+		const auto lastColor = m_ColorRuns.Empty() ? std::nullopt : m_ColorRuns.Back().Color;
+
+		if (m_CurrentColor != lastColor)
+			m_ColorRuns.PushBack({ uint32_t(m_Text.Size()), m_CurrentColor });
+
+		m_Text.Append(str.data(), str.size());
 		return *this;
 	}
 }
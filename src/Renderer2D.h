@@ -1,11 +1,14 @@
 #pragma once
 
 #include "Common.h"
-#include "Renderer2D.h"
+#include "Affine2D.h"
+#include "SmallVector.h"
 
 #include <array>
 #include <memory>
 #include <stack>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <optional>
 #include <vector>
@@ -38,7 +41,10 @@ namespace bsf
 	struct Renderer2DState
 	{
 		Ref<Texture2D> CurrentTexture = nullptr;
-		glm::mat4 Matrix = glm::identity<glm::mat4>();
+		uint16_t TextureSlot = 0;
+		uint32_t TextureGeneration = 0; // Batch generation TextureSlot refers to
+		glm::vec2 UvOffset = { 0.0f, 0.0f }, UvScale = { 1.0f, 1.0f }; // Sub-rect of atlas views
+		Affine2D Transform;
 		glm::vec4 Color = { 1.0f, 1.0f, 1.0f, 1.0f };
 		glm::vec4 TextShadowColor = { 0.0f, 0.0f, 0.0f, 1.0f };
 		glm::vec2 TextShadowOffset = { 0.1f, 0.1f };
@@ -47,36 +53,43 @@ namespace bsf
 	};
 
 
+	// Text with color runs. Short strings with a few color changes are stored inline,
+	// so building one every frame (counters, labels) doesn't allocate
 	struct FormattedString
 	{
 	public:
 
-		struct Character
+		// The color of the characters from Begin up to the next run, no color
+		// means the characters keep the current one
+		struct ColorRun
 		{
-			char Code;
+			uint32_t Begin;
 			std::optional<glm::vec4> Color;
+
+			bool operator==(const ColorRun&) const = default;
 		};
 
 		FormattedString() = default;
-		FormattedString(const char* ch);
-		FormattedString(const std::string& str);
+		FormattedString(const char* ch) : FormattedString(std::string_view(ch)) {}
+		FormattedString(const std::string& str) : FormattedString(std::string_view(str)) {}
+		FormattedString(std::string_view str);
 
 		FormattedString& Color(const glm::vec4& color);
 		FormattedString& ResetColor();
 
-		FormattedString& Add(const std::string& str);
+		FormattedString& Add(std::string_view str);
 
-		size_t Size() const { return m_Characters.size(); }
+		size_t Size() const { return m_Text.Size(); }
 
-		const std::string& GetPlainText() const { return m_PlainText; }
+		std::string_view GetPlainText() const { return { m_Text.Data(), m_Text.Size() }; }
+		const SmallVector<ColorRun, 4>& GetColorRuns() const { return m_ColorRuns; }
 
-		const Character& operator[](size_t i) const { return m_Characters[i]; }
-		FormattedString& operator+=(const std::string& str) { return Add(str); }
-		FormattedString& operator+=(char c) { return Add(std::string(1, c)); }
+		FormattedString& operator+=(std::string_view str) { return Add(str); }
+		FormattedString& operator+=(char c) { return Add({ &c, 1 }); }
 
 	private:
-		std::string m_PlainText;
-		std::vector<Character> m_Characters;
+		SmallVector<char, 32> m_Text;
+		SmallVector<ColorRun, 4> m_ColorRuns;
 		std::optional<glm::vec4> m_CurrentColor = std::nullopt;
 	};
 
@@ -121,33 +134,74 @@ namespace bsf
 		void Pop();
 
 		void End();
+
+		// Batches with at most one texture are drawn by a shader with a single sampler,
+		// disabling this always uses the one selecting among 32 samplers
+		void SetSingleSamplerPath(bool enabled) { m_SingleSamplerPath = enabled; }
+		bool GetSingleSamplerPath() const { return m_SingleSamplerPath; }
 	private:
 
+		// Texture slot and clip rect are indices into per batch tables (texture units and
+		// the uClipRects uniform array), the index 0 means no texture and no clip
 		struct Vertex2D
 		{
 			glm::vec2 Postion;
 			glm::vec2 UV;
 			glm::vec4 Color;
-			uint32_t TextureID;
-			uint32_t Clip;
-			glm::vec4 ClipPlanes;
+			uint16_t TextureSlot;
+			uint16_t ClipIndex;
+		};
+
+		// Glyph quads of a string in local space, the baseline starts at the origin
+		struct TextLayout
+		{
+			struct Glyph
+			{
+				std::array<glm::vec2, 4> Positions;
+				std::array<glm::vec2, 4> UVs;
+				std::optional<glm::vec4> Color;
+			};
+
+			const Font* LayoutFont;
+			std::string Text;
+			std::vector<FormattedString::ColorRun> ColorRuns;
+			std::vector<Glyph> Glyphs;
+			float Width;
+			uint32_t LastUsed; // Value of m_TextTick
 		};
 
-		using Triangle2D = std::array<Vertex2D, 3>;
+		bool BeginBatch();
+		void DrawQuadInternal(const std::array<glm::vec2, 4>& positions, const std::array<glm::vec2, 4>& uvs);
+		void DrawQuadInternal(const Affine2D& transform, const glm::vec4& color, const std::array<glm::vec2, 4>& positions, const std::array<glm::vec2, 4>& uvs);
 
+		const TextLayout& GetTextLayout(const Ref<Font>& font, const FormattedString& str);
+		void DrawTextLayout(const Ref<Font>& font, const TextLayout& layout, const glm::vec2& position, const std::optional<glm::vec4>& color);
 
-		void DrawTriangleInternal(const std::array<glm::vec2, 3>& positions, const std::array<glm::vec2, 3>& uvs);
+		uint16_t FindTextureSlot(const Ref<Texture2D>& texture);
+		uint16_t GetTextureSlot(Renderer2DState& state);
+		uint16_t GetClipIndex(const std::optional<Rect>& clip);
 
 
 		std::vector<uint32_t> m_Textures;
+		uint32_t m_TextureCount = 1;
+		uint32_t m_BatchGeneration = 1;
 		std::vector<int32_t> m_TextureUnits;
+		std::vector<glm::vec4> m_ClipRects;
+		uint16_t m_LastClipIndex = 0;
 		std::stack<Renderer2DState> m_State;
 		glm::mat4 m_Projection;
-		Vertex2D* m_TriangleVertices;
-		size_t m_CurVertexIndex;
-		Ref<VertexArray> m_Triangles;
-
-		Ref<ShaderProgram> m_pTriangleProgram;
+		Vertex2D* m_QuadVertices; // Mapped vertex buffer, only while a batch is open
+		size_t m_QuadCount;
+		size_t m_BatchCapacity;
+		uint32_t m_BatchStart, m_StreamOffset; // In vertices
+		Ref<VertexArray> m_Quads;
+
+		std::unordered_multimap<size_t, TextLayout> m_TextLayouts; // By hash of font and formatted string
+		uint32_t m_TextTick = 0; // Incremented by Begin
+
+		Ref<ShaderProgram> m_pQuadProgram;
+		Ref<ShaderProgram> m_pSingleSamplerProgram;
+		bool m_SingleSamplerPath = true;
 
 	};
 
@@ -4,11 +4,14 @@
 #include <glm/ext.hpp>
 
 #include "Scene.h" 
+#include "SceneCoroutine.h"
 #include "Application.h"
 #include "Renderer2D.h"
 
 namespace bsf
 {
+	Scene::Scene() = default;
+
 	Scene::~Scene()
 	{
 	}
@@ -33,9 +36,67 @@ namespace bsf
 		return *m_App;
 	}
 
-	void Scene::ScheduleTask(ESceneTaskEvent evt, const Ref<SceneTask>& task)
+	void Scene::ScheduleTask(ESceneTaskEvent evt, SceneTask* task)
+	{
+		assert(task->m_Scene == this);
+		task->m_Event = evt;
+		m_ScheduledTasks[size_t(evt)].PushBack(task);
+	}
+
+	bool Scene::HasScheduledTasks() const
 	{
-		m_ScheduledTasks[evt].push_back(task);
+		for (const auto& list : m_ScheduledTasks)
+			if (list.Front() != nullptr)
+				return true;
+		return false;
+	}
+
+	CoroutineTask* Scene::StartCoroutine(ESceneTaskEvent evt, SceneCoroutine&& coroutine)
+	{
+		return ScheduleTask<CoroutineTask>(evt, std::move(coroutine));
+	}
+
+	SceneArena& Scene::GetCoroutineArena()
+	{
+		if (!m_CoroutineArena)
+			m_CoroutineArena = std::make_unique<SceneArena>();
+		return *m_CoroutineArena;
+	}
+
+	void Scene::ReleaseTask(SceneTask* task)
+	{
+		// Release captured resources now, the instance is destroyed when reused
+		task->m_UpdateFn = nullptr;
+		task->m_DoneFn = nullptr;
+		m_FreeTasks[task->m_TypeId].push_back(task);
+	}
+
+	void SceneTaskList::PushBack(SceneTask* task)
+	{
+		task->m_Prev = m_Tail;
+		task->m_Next = nullptr;
+
+		if (m_Tail != nullptr)
+			m_Tail->m_Next = task;
+		else
+			m_Head = task;
+
+		m_Tail = task;
+	}
+
+	void SceneTaskList::Remove(SceneTask* task)
+	{
+		if (task->m_Prev != nullptr)
+			task->m_Prev->m_Next = task->m_Next;
+		else
+			m_Head = task->m_Next;
+
+		if (task->m_Next != nullptr)
+			task->m_Next->m_Prev = task->m_Prev;
+		else
+			m_Tail = task->m_Prev;
+
+		task->m_Prev = task->m_Next = nullptr;
 	}
 
 	FadeTask::FadeTask(glm::vec4 fromColor, glm::vec4 toColor, float duration) :
@@ -51,14 +112,7 @@ namespace bsf
 			m_Time = std::min(m_Time + time.Delta, m_Duration);
 
 			float delta = m_Time / m_Duration;
-			auto& renderer2d = GetApplication().GetRenderer2D();
-
-			renderer2d.Begin(glm::ortho(0.0f, 1.0f, 0.0f, 1.0f));
-			renderer2d.Pivot(EPivot::BottomLeft);
-			renderer2d.Color(glm::mix(m_FromColor, m_ToColor, delta));
-			renderer2d.DrawQuad({ 0, 0 });
-			renderer2d.End();
-
+			DrawFade(GetApplication(), glm::mix(m_FromColor, m_ToColor, delta));
 
 			if (m_Time == m_Duration)
 				SetDone();
@@ -67,6 +121,17 @@ namespace bsf
 	}
 
 
+	void DrawFade(Application& app, const glm::vec4& color)
+	{
+		auto& renderer2d = app.GetRenderer2D();
+
+		renderer2d.Begin(glm::ortho(0.0f, 1.0f, 0.0f, 1.0f));
+		renderer2d.Pivot(EPivot::BottomLeft);
+		renderer2d.Color(color);
+		renderer2d.DrawQuad({ 0, 0 });
+		renderer2d.End();
+	}
+
 	void SceneTask::CallUpdateFn(const Time& time)
 	{
 		if (!m_IsStarted)
@@ -83,7 +148,7 @@ namespace bsf
 			m_DoneFn(*this);
 	}
 
-	Ref<SceneTask> SceneTask::Chain(Ref<SceneTask> next)
+	SceneTask* SceneTask::Chain(SceneTask* next)
 	{
 		SetDoneFunction([&, next](SceneTask& self) { GetScene().ScheduleTask(GetEvent(), next); });
 		return next;
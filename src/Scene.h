@@ -3,16 +3,19 @@
 #include "Ref.h"
 #include "Time.h"
 #include "EventEmitter.h"
+#include "InplaceFunction.h"
 
-#include <list>
-#include <unordered_map>
-#include <functional>
+#include <array>
+#include <memory>
 #include <vector>
 
 namespace bsf
 {
 	class Application;
 	class Scene;
+	class SceneArena;
+	class SceneCoroutine;
+	class CoroutineTask;
 
 	enum class ESceneTaskEvent
 	{
@@ -20,11 +23,22 @@ namespace bsf
 		PostRender
 	};
 
+	static constexpr size_t s_SceneTaskEventCount = 2;
+
+	inline uint32_t s_NextSceneTaskTypeId = 0;
+
+	template<typename T>
+	uint32_t GetSceneTaskTypeId()
+	{
+		static const uint32_t id = s_NextSceneTaskTypeId++;
+		return id;
+	}
+
 	class SceneTask
 	{
 	public:
-		using DoneFn = std::function<void(SceneTask &)>;
-		using UpdateFn = std::function<void(SceneTask &, const Time &)>;
+		using DoneFn = InplaceFunction<void(SceneTask &), 64>;
+		using UpdateFn = InplaceFunction<void(SceneTask &, const Time &), 64>;
 
 		SceneTask() : m_DoneFn(nullptr), m_UpdateFn(nullptr), m_Application(nullptr),
 					  m_IsDone(false), m_IsStarted(false) {}
@@ -47,7 +61,7 @@ namespace bsf
 		void SetDoneFunction(const DoneFn &fn) { m_DoneFn = fn; }
 		void SetDoneFunction(DoneFn &&fn) { m_DoneFn = std::move(fn); }
 
-		Ref<SceneTask> Chain(Ref<SceneTask> next);
+		SceneTask* Chain(SceneTask* next);
 
 		const Time &GetStartTime() const { return m_StartTime; }
 
@@ -64,6 +78,8 @@ namespace bsf
 		void CallDoneFn();
 
 		friend class Application;
+		friend class Scene;
+		friend class SceneTaskList;
 		Application *m_Application = nullptr;
 		Scene *m_Scene = nullptr;
 		ESceneTaskEvent m_Event = ESceneTaskEvent::PreRender;
@@ -72,6 +88,23 @@ namespace bsf
 		Time m_StartTime;
 		bool m_IsStarted;
 		bool m_IsDone;
+
+		// Scheduling (intrusive list) and pooling
+		SceneTask *m_Prev = nullptr, *m_Next = nullptr;
+		uint32_t m_TypeId = 0;
+	};
+
+	// Intrusive list of scheduled tasks, no allocations when tasks are added or removed
+	class SceneTaskList
+	{
+	public:
+		void PushBack(SceneTask* task);
+		void Remove(SceneTask* task);
+
+		SceneTask* Front() const { return m_Head; }
+
+	private:
+		SceneTask *m_Head = nullptr, *m_Tail = nullptr;
 	};
 
 	class FadeTask : public SceneTask
@@ -84,6 +117,9 @@ namespace bsf
 		glm::vec4 m_FromColor, m_ToColor;
 	};
 
+	// Draws a full screen quad with the given color on top of the scene
+	void DrawFade(Application& app, const glm::vec4& color);
+
 	class WaitForTask : public SceneTask
 	{
 	public:
@@ -96,7 +132,7 @@ namespace bsf
 	class Scene : public EventReceiver
 	{
 	public:
-		Scene() = default;
+		Scene();
 		Scene(Scene &&) = delete;
 
 		virtual ~Scene();
@@ -104,21 +140,73 @@ namespace bsf
 		virtual void OnRender(const Time &time);
 		virtual void OnDetach();
 
+		// Whether the scene changes on screen without input. When it doesn't and there are
+		// no scheduled tasks, the application can drop to a low frame rate to save power
+		virtual bool IsAnimating() const { return true; }
+
+		bool HasScheduledTasks() const;
+
 		Application &GetApplication();
 
-		void ScheduleTask(ESceneTaskEvent evt, const Ref<SceneTask> &task);
+		void ScheduleTask(ESceneTaskEvent evt, SceneTask *task);
 
+		// Tasks are owned by the scene. Instances of completed tasks are reused
+		// when a new task of the same type is created
 		template <typename T, typename... Args>
-		Ref<std::enable_if_t<std::is_base_of_v<SceneTask, T>, T>> ScheduleTask(ESceneTaskEvent evt, Args &&... args)
+		std::enable_if_t<std::is_base_of_v<SceneTask, T>, T>* CreateTask(Args &&... args)
 		{
-			auto task = MakeRef<T>(std::forward<Args>(args)...);
+			const uint32_t typeId = GetSceneTaskTypeId<T>();
+
+			if (typeId >= m_FreeTasks.size())
+				m_FreeTasks.resize(typeId + 1);
+
+			auto& freeTasks = m_FreeTasks[typeId];
+			T* task = nullptr;
+
+			if (!freeTasks.empty())
+			{
+				task = static_cast<T*>(freeTasks.back());
+				freeTasks.pop_back();
+				task->~T();
+				new (task) T(std::forward<Args>(args)...);
+			}
+			else
+			{
+				auto storage = std::make_unique<T>(std::forward<Args>(args)...);
+				task = storage.get();
+				m_TaskStorage.push_back(std::move(storage));
+			}
+
+			task->m_TypeId = typeId;
+			task->m_Scene = this;
+
+			return task;
+		}
+
+		template <typename T, typename... Args>
+		std::enable_if_t<std::is_base_of_v<SceneTask, T>, T>* ScheduleTask(ESceneTaskEvent evt, Args &&... args)
+		{
+			auto task = CreateTask<T>(std::forward<Args>(args)...);
 			ScheduleTask(evt, task);
 			return task;
 		}
 
+		// Runs a scene script, resumed every frame on the given event until it completes
+		CoroutineTask* StartCoroutine(ESceneTaskEvent evt, SceneCoroutine&& coroutine);
+
+		SceneArena& GetCoroutineArena();
+
 	private:
 		friend class Application;
-		std::unordered_map<ESceneTaskEvent, std::list<Ref<SceneTask>>> m_ScheduledTasks;
+
+		void ReleaseTask(SceneTask* task);
+
+		std::array<SceneTaskList, s_SceneTaskEventCount> m_ScheduledTasks;
+
+		// Declared before the tasks storage, unfinished coroutines free their frames on destruction
+		std::unique_ptr<SceneArena> m_CoroutineArena;
+		std::vector<std::unique_ptr<SceneTask>> m_TaskStorage;
+		std::vector<std::vector<SceneTask*>> m_FreeTasks;
 		Application *m_App = nullptr;
 	};
 
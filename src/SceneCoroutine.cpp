@@ -0,0 +1,153 @@
+#include "BsfPch.h"
+
+#include <glm/ext.hpp>
+
+#include "SceneCoroutine.h"
+#include "Application.h"
+#include "Renderer2D.h"
+
+namespace bsf
+{
+	void* SceneArena::Allocate(size_t size)
+	{
+		const size_t totalSize = size + sizeof(Header);
+
+		size_t sizeClass = 0;
+		while (sizeClass < s_SizeClasses && (s_MinSize << sizeClass) < totalSize)
+			++sizeClass;
+
+		Header* header = nullptr;
+
+		if (sizeClass == s_SizeClasses)
+		{
+			// Too big for the arena
+			header = static_cast<Header*>(::operator new(totalSize));
+			header->Arena = nullptr;
+		}
+		else if (m_FreeLists[sizeClass] != nullptr)
+		{
+			auto node = m_FreeLists[sizeClass];
+			m_FreeLists[sizeClass] = node->Next;
+			header = reinterpret_cast<Header*>(node);
+			header->Arena = this;
+		}
+		else
+		{
+			const size_t classSize = s_MinSize << sizeClass;
+
+			if (m_BlockOffset + classSize > s_BlockSize)
+			{
+				m_Blocks.push_back(std::make_unique<std::byte[]>(s_BlockSize));
+				m_BlockOffset = 0;
+			}
+
+			header = reinterpret_cast<Header*>(m_Blocks.back().get() + m_BlockOffset);
+			header->Arena = this;
+			m_BlockOffset += classSize;
+		}
+
+		header->SizeClass = sizeClass;
+		return header + 1;
+	}
+
+	void SceneArena::Free(void* ptr)
+	{
+		if (ptr == nullptr)
+			return;
+
+		Header* header = static_cast<Header*>(ptr) - 1;
+		SceneArena* arena = header->Arena;
+
+		if (arena == nullptr)
+		{
+			::operator delete(header);
+			return;
+		}
+
+		const size_t sizeClass = header->SizeClass;
+		auto node = reinterpret_cast<FreeNode*>(header);
+		node->Next = arena->m_FreeLists[sizeClass];
+		arena->m_FreeLists[sizeClass] = node;
+	}
+
+	SceneCoroutine& SceneCoroutine::operator=(SceneCoroutine&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Destroy();
+			m_Handle = other.m_Handle;
+			other.m_Handle = nullptr;
+		}
+		return *this;
+	}
+
+	void SceneCoroutine::Destroy()
+	{
+		if (m_Handle)
+		{
+			m_Handle.destroy();
+			m_Handle = nullptr;
+		}
+	}
+
+	bool WaitFor::Update(SceneTask& task, const Time& time)
+	{
+		m_Time += time.Delta;
+		return m_Time >= m_Duration;
+	}
+
+	Fade::Fade(const glm::vec4& fromColor, const glm::vec4& toColor, float duration) :
+		m_FromColor(fromColor),
+		m_ToColor(toColor),
+		m_Duration(duration)
+	{
+		assert(duration > 0.0f);
+	}
+
+	bool Fade::Update(SceneTask& task, const Time& time)
+	{
+		m_Time = std::min(m_Time + time.Delta, m_Duration);
+		DrawFade(task.GetApplication(), glm::mix(m_FromColor, m_ToColor, m_Time / m_Duration));
+		return m_Time == m_Duration;
+	}
+
+	bool NextFrame::Update(SceneTask& task, const Time& time)
+	{
+		m_Time = time;
+
+		if (!m_Started)
+		{
+			m_Started = true;
+			return false;
+		}
+
+		return true;
+	}
+
+	CoroutineTask::CoroutineTask(SceneCoroutine&& coroutine) :
+		m_Coroutine(std::move(coroutine))
+	{
+		SetUpdateFunction([&](SceneTask& self, const Time& time) {
+
+			auto handle = m_Coroutine.GetHandle();
+			auto& promise = handle.promise();
+			Time step = time;
+
+			while (promise.Awaiter == nullptr || promise.Awaiter->Update(*this, step))
+			{
+				promise.Awaiter = nullptr;
+				handle.resume();
+
+				if (handle.done())
+				{
+					m_Coroutine.Destroy();
+					SetDone();
+					return;
+				}
+
+				// The next awaiter starts in this frame, but no time has passed for it yet
+				step = { 0.0f, time.Elapsed };
+			}
+		});
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Scene.h"
+#include "Time.h"
+
+#include <coroutine>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace bsf
+{
+	class SceneAwaiter;
+
+	// Per-scene allocator for coroutine frames. Freed frames go back to a size class
+	// free list, so after the first few coroutines no more memory is allocated
+	class SceneArena
+	{
+	public:
+		SceneArena() = default;
+		SceneArena(const SceneArena&) = delete;
+		SceneArena(SceneArena&&) = delete;
+
+		void* Allocate(size_t size);
+		static void Free(void* ptr);
+
+	private:
+		static constexpr size_t s_BlockSize = 16 * 1024;
+		static constexpr size_t s_MinSize = 64;
+		static constexpr size_t s_SizeClasses = 7; // 64 to 4096 bytes
+
+		struct alignas(std::max_align_t) Header
+		{
+			SceneArena* Arena;
+			size_t SizeClass;
+		};
+
+		struct FreeNode
+		{
+			FreeNode* Next;
+		};
+
+		std::vector<std::unique_ptr<std::byte[]>> m_Blocks;
+		std::array<FreeNode*, s_SizeClasses> m_FreeLists = {};
+		size_t m_BlockOffset = s_BlockSize;
+	};
+
+	struct SceneCoroutinePromise;
+
+	// Return type of scene scripts. Scripts must be member functions of a scene (or take the
+	// scene as first parameter) since the coroutine frame is allocated from the scene arena.
+	// Run them with Scene::StartCoroutine
+	class SceneCoroutine
+	{
+	public:
+		using promise_type = SceneCoroutinePromise;
+		using Handle = std::coroutine_handle<SceneCoroutinePromise>;
+
+		SceneCoroutine() = default;
+		explicit SceneCoroutine(Handle handle) : m_Handle(handle) {}
+		SceneCoroutine(const SceneCoroutine&) = delete;
+		SceneCoroutine(SceneCoroutine&& other) noexcept : m_Handle(other.m_Handle) { other.m_Handle = nullptr; }
+		~SceneCoroutine() { Destroy(); }
+
+		SceneCoroutine& operator=(SceneCoroutine&& other) noexcept;
+
+		Handle GetHandle() const { return m_Handle; }
+		bool IsDone() const { return !m_Handle || m_Handle.done(); }
+
+		void Destroy();
+
+	private:
+		Handle m_Handle = nullptr;
+	};
+
+	struct SceneCoroutinePromise
+	{
+		SceneAwaiter* Awaiter = nullptr;
+
+		template<typename S, typename... Args, typename = std::enable_if_t<std::is_base_of_v<Scene, S>>>
+		static void* operator new(size_t size, S& scene, Args&...)
+		{
+			return scene.GetCoroutineArena().Allocate(size);
+		}
+
+		static void operator delete(void* ptr, size_t) { SceneArena::Free(ptr); }
+
+		SceneCoroutine get_return_object() { return SceneCoroutine(SceneCoroutine::Handle::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	// Base class for things that can be awaited inside a scene coroutine. Update is called
+	// every frame (with no elapsed time the first time) until it returns true
+	class SceneAwaiter
+	{
+	public:
+		virtual ~SceneAwaiter() = default;
+
+		virtual bool Update(SceneTask& task, const Time& time) = 0;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(SceneCoroutine::Handle handle) noexcept { handle.promise().Awaiter = this; }
+		void await_resume() const noexcept {}
+	};
+
+	class WaitFor : public SceneAwaiter
+	{
+	public:
+		WaitFor(float seconds) : m_Duration(seconds) {}
+		bool Update(SceneTask& task, const Time& time) override;
+	private:
+		float m_Duration, m_Time = 0.0f;
+	};
+
+	class Fade : public SceneAwaiter
+	{
+	public:
+		Fade(const glm::vec4& fromColor, const glm::vec4& toColor, float duration);
+		bool Update(SceneTask& task, const Time& time) override;
+	private:
+		glm::vec4 m_FromColor, m_ToColor;
+		float m_Duration, m_Time = 0.0f;
+	};
+
+	// Resumes on the next frame, with the time of that frame
+	class NextFrame : public SceneAwaiter
+	{
+	public:
+		bool Update(SceneTask& task, const Time& time) override;
+		Time await_resume() const noexcept { return m_Time; }
+	private:
+		Time m_Time;
+		bool m_Started = false;
+	};
+
+	class CoroutineTask : public SceneTask
+	{
+	public:
+		CoroutineTask(SceneCoroutine&& coroutine);
+	private:
+		SceneCoroutine m_Coroutine;
+	};
+
+}
@@ -10,6 +10,7 @@
 
 #define UNIFORM_IMPL(type, varType, size) \
 	void ShaderProgram::Uniform ## size ## type ## v(uint64_t hash, uint32_t count, const varType * ptr) { \
+		BSF_GLSTAT(UniformUploads); \
 		BSF_GLCALL(glUniform ## size ## type ## v(GetUniformLocation(hash), count, ptr)); \
 	}
 
@@ -131,9 +132,10 @@ namespace bsf
 
 	ShaderProgram::ShaderProgram(const std::initializer_list<std::pair<ShaderType, std::string_view>>& sources)
 	{
-		static constexpr std::array<GLenum, 2> samplerTypes = {
+		static constexpr std::array<GLenum, 3> samplerTypes = {
 			GL_SAMPLER_2D,
-			GL_SAMPLER_CUBE
+			GL_SAMPLER_CUBE,
+			GL_UNSIGNED_INT_SAMPLER_2D
 		};
 
 		m_Id = LoadProgram(sources);
@@ -198,16 +200,26 @@ namespace bsf
 
 	void ShaderProgram::UniformMatrix4f(uint64_t hash, const glm::mat4& matrix)
 	{
+		BSF_GLSTAT(UniformUploads);
 		BSF_GLCALL(glUniformMatrix4fv(GetUniformLocation(hash), 1, GL_FALSE, glm::value_ptr(matrix)));
 	}
 
 	void ShaderProgram::UniformMatrix4fv(uint64_t hash, size_t count, const float* ptr)
 	{
+		BSF_GLSTAT(UniformUploads);
 		BSF_GLCALL(glUniformMatrix4fv(GetUniformLocation(hash), count, GL_FALSE, ptr));
 	}
 
 	void ShaderProgram::Use()
 	{
+#ifdef BSF_ENABLE_DIAGNOSTIC
+		static uint32_t s_CurrentProgram = 0;
+		if (s_CurrentProgram != m_Id)
+		{
+			s_CurrentProgram = m_Id;
+			BSF_GLSTAT(ProgramSwitches);
+		}
+#endif
 		BSF_GLCALL(glUseProgram(m_Id));
 	}
 
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace bsf
+{
+	// Vector of trivially copyable values keeping the first Capacity of them inside the object.
+	// It moves everything to the heap only when it grows past that
+	template<typename T, size_t Capacity>
+	class SmallVector
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "SmallVector only holds trivially copyable types");
+
+	public:
+
+		SmallVector() = default;
+		SmallVector(const SmallVector&) = default;
+		SmallVector(SmallVector&& other) noexcept :
+			m_Inline(other.m_Inline),
+			m_Heap(std::move(other.m_Heap)),
+			m_Size(other.m_Size)
+		{
+			other.Clear();
+		}
+
+		SmallVector& operator=(const SmallVector&) = default;
+		SmallVector& operator=(SmallVector&& other) noexcept
+		{
+			if (this != &other)
+			{
+				m_Inline = other.m_Inline;
+				m_Heap = std::move(other.m_Heap);
+				m_Size = other.m_Size;
+				other.Clear();
+			}
+			return *this;
+		}
+
+		void PushBack(const T& value) { Append(&value, 1); }
+
+		void Append(const T* values, size_t count)
+		{
+			if (count == 0)
+				return;
+
+			if (m_Size + count > Capacity)
+			{
+				if (m_Heap.empty())
+					m_Heap.assign(m_Inline.begin(), m_Inline.begin() + m_Size);
+
+				m_Heap.insert(m_Heap.end(), values, values + count);
+			}
+			else
+			{
+				std::memcpy(m_Inline.data() + m_Size, values, count * sizeof(T));
+			}
+
+			m_Size += count;
+		}
+
+		void Clear()
+		{
+			m_Heap.clear();
+			m_Size = 0;
+		}
+
+		size_t Size() const { return m_Size; }
+		bool Empty() const { return m_Size == 0; }
+		bool IsInline() const { return m_Heap.empty(); }
+
+		T* Data() { return IsInline() ? m_Inline.data() : m_Heap.data(); }
+		const T* Data() const { return IsInline() ? m_Inline.data() : m_Heap.data(); }
+
+		T& operator[](size_t i) { return Data()[i]; }
+		const T& operator[](size_t i) const { return Data()[i]; }
+
+		T& Back() { return Data()[m_Size - 1]; }
+		const T& Back() const { return Data()[m_Size - 1]; }
+
+		T* begin() { return Data(); }
+		T* end() { return Data() + m_Size; }
+		const T* begin() const { return Data(); }
+		const T* end() const { return Data() + m_Size; }
+
+	private:
+		std::array<T, Capacity> m_Inline = {};
+		std::vector<T> m_Heap; // Holds all the values once they don't fit inline
+		size_t m_Size = 0;
+	};
+}
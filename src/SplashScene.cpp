@@ -51,20 +51,20 @@ namespace bsf
 		AddSubscription(app.WindowResized, this, &SplashScene::OnResize);
 
 		// fadeIn
-		auto fadeIn = MakeRef<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, 0.5f);
+		auto fadeIn = CreateTask<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, 0.5f);
 		ScheduleTask(ESceneTaskEvent::PostRender, fadeIn);
 
 		{
-			auto wait = MakeRef<WaitForTask>(s_FadeOutTime);
-			auto fadeOut = MakeRef<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, s_FadeDuration);
-			auto change = MakeRef<SceneTask>([&](SceneTask& self, const Time& time) { m_DisplayTitle = true; self.SetDone(); });
-			auto fadeIn = MakeRef<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, s_FadeDuration);
+			auto wait = CreateTask<WaitForTask>(s_FadeOutTime);
+			auto fadeOut = CreateTask<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, s_FadeDuration);
+			auto change = CreateTask<SceneTask>([&](SceneTask& self, const Time& time) { m_DisplayTitle = true; self.SetDone(); });
+			auto fadeIn = CreateTask<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, s_FadeDuration);
 			wait->Chain(fadeOut)->Chain(change)->Chain(fadeIn);
 			ScheduleTask(ESceneTaskEvent::PostRender, wait);
 		}
 
 		// Play intro sound
-		auto playIntroSound = MakeRef<SceneTask>();
+		auto playIntroSound = CreateTask<SceneTask>();
 		playIntroSound->SetUpdateFunction([&](SceneTask &self, const Time &time) {
 			Assets::GetInstance().Get<Audio>(AssetName::SfxIntro)->Play();
 			self.SetDone();
@@ -75,7 +75,7 @@ namespace bsf
 		AddSubscription(GetApplication().KeyPressed, [&](const KeyPressedEvent &evt) {
 			if (evt.KeyCode == GLFW_KEY_ENTER)
 			{
-				auto fadeOut = MakeRef<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, 0.5f);
+				auto fadeOut = CreateTask<FadeTask>(glm::vec4{1.0f, 1.0f, 1.0f, 0.0f}, glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}, 0.5f);
 
 				fadeOut->SetDoneFunction([&](SceneTask &self) {
 					GetApplication().GotoScene(MakeRef<MenuScene>());
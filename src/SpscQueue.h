@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace bsf
+{
+	// Bounded lock free queue for one producer thread and one consumer thread.
+	// Push fails when the queue is full, nothing is ever overwritten
+	template<typename T, size_t Capacity>
+	class SpscQueue
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	public:
+
+		// Producer side
+		bool Push(const T& item)
+		{
+			const size_t tail = m_Tail.load(std::memory_order_relaxed);
+
+			if (tail - m_Head.load(std::memory_order_acquire) == Capacity)
+				return false;
+
+			m_Items[tail & (Capacity - 1)] = item;
+			m_Tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Producer side, the consumer might free some more in the meantime
+		size_t GetFreeSpace() const
+		{
+			return Capacity - (m_Tail.load(std::memory_order_relaxed) - m_Head.load(std::memory_order_acquire));
+		}
+
+		// Consumer side. Items pushed while draining are left for the next call
+		template<typename Fn>
+		void Drain(Fn&& fn)
+		{
+			size_t head = m_Head.load(std::memory_order_relaxed);
+			const size_t tail = m_Tail.load(std::memory_order_acquire);
+
+			for (; head != tail; ++head)
+			{
+				fn(m_Items[head & (Capacity - 1)]);
+				m_Head.store(head + 1, std::memory_order_release);
+			}
+		}
+
+		// Consumer side, nullptr when empty. The item stays in the queue until Pop
+		const T* Front() const
+		{
+			const size_t head = m_Head.load(std::memory_order_relaxed);
+
+			if (head == m_Tail.load(std::memory_order_acquire))
+				return nullptr;
+
+			return &m_Items[head & (Capacity - 1)];
+		}
+
+		// Consumer side, only after Front returned an item
+		void Pop()
+		{
+			m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		// Consumer side
+		bool Empty() const
+		{
+			return m_Head.load(std::memory_order_relaxed) == m_Tail.load(std::memory_order_acquire);
+		}
+
+	private:
+		std::array<T, Capacity> m_Items = {};
+		alignas(64) std::atomic<size_t> m_Head = 0;
+		alignas(64) std::atomic<size_t> m_Tail = 0;
+	};
+}
@@ -1,5 +1,6 @@
 #include "BsfPch.h"
 
+#include <atomic>
 #include <bitset>
 #include <json/json.hpp>
 
@@ -15,6 +16,8 @@ namespace bsf
 	static constexpr uint32_t s_CurrentVersion = 201;
 	static constexpr std::string_view s_SortedStagesFile = "assets/data/stages.json";
 
+	static std::atomic<uint32_t> s_NextRevision = 0;
+
 #pragma region Loaders
 
 	using LoaderFn = void(*)(Stage&, const nlohmann::json& json);
@@ -178,6 +181,7 @@ namespace bsf
 		m_AvoidSearch.resize((size_t)size * size);
 		std::fill(m_Data.begin(), m_Data.end(), EStageObject::None);
 		std::fill(m_AvoidSearch.begin(), m_AvoidSearch.end(), EAvoidSearch::No);
+		Touch();
 	}
 
 	Stage::Stage() : Stage(32)
@@ -208,6 +212,7 @@ namespace bsf
 	{
 		Wrap(x); Wrap(y);
 		m_Data[(size_t)y * m_Size + x] = obj;
+		Touch();
 	}
 
 	EAvoidSearch Stage::GetAvoidSearchAt(int32_t x, int32_t y) const
@@ -219,6 +224,7 @@ namespace bsf
 	{
 		Wrap(x); Wrap(y);
 		m_AvoidSearch[(size_t)y * m_Size + x] = val;
+		Touch();
 	}
 
 	uint32_t Stage::Count(EStageObject object) const
@@ -230,12 +236,14 @@ namespace bsf
 	{
 		assert(data.size() == m_Size * m_Size);
 		m_Data = std::move(data);
+		Touch();
 	}
 
 	void Stage::SetAvoidSearch(std::vector<EAvoidSearch>&& as)
 	{
 		assert(as.size() == m_Size * m_Size);
 		m_AvoidSearch = std::move(as);
+		Touch();
 	}
 
 
@@ -262,6 +270,7 @@ namespace bsf
 		m_Size = size;
 		m_Data = std::move(newData);
 		m_AvoidSearch = std::move(newAvoidSearch);
+		Touch();
 
 		return true;
 
@@ -289,6 +298,11 @@ namespace bsf
 		coord %= m_Size;
 	}
 
+	void Stage::Touch()
+	{
+		m_Revision = ++s_NextRevision;
+	}
+
 
 
 	#pragma region Stage Generator
@@ -110,13 +110,18 @@ namespace bsf
 
 		bool Resize(int32_t size);
 
+		// Changes whenever the objects or avoid search data change, unique among all stages
+		uint32_t GetRevision() const { return m_Revision; }
+
 		bool operator==(const Stage& other) const;
 
 	private:
 
 		int32_t m_Size;
+		uint32_t m_Revision = 0;
 	
 		void Wrap(int32_t& coord) const;
+		void Touch();
 
 		std::vector<EStageObject> m_Data;
 		std::vector<EAvoidSearch> m_AvoidSearch;
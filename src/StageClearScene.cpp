@@ -9,6 +9,7 @@
 #include "GameScene.h"
 #include "SplashScene.h"
 #include "Audio.h"
+#include "SceneCoroutine.h"
 
 namespace bsf
 {
@@ -37,66 +38,61 @@ namespace bsf
 		// Play sound
 		Assets::GetInstance().Get<Audio>(AssetName::SfxStageClear)->Play();
 
-		// Tasks
-		auto fadeIn = MakeRef<FadeTask>(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f }, glm::vec4{ 1.0f, 1.0f, 1.0f, 0.0f }, 0.5f);
-		ScheduleTask(ESceneTaskEvent::PostRender, fadeIn);
+		// Script
+		StartCoroutine(ESceneTaskEvent::PostRender, RunTally());
 
+		// Input
+		AddSubscription(app.KeyReleased, [&](const KeyReleasedEvent& evt) {
 
-		auto waitForUpdate = MakeRef<WaitForTask>(3.0f);
-		waitForUpdate->SetDoneFunction([&](SceneTask& self) {
-
-			auto updateScore = MakeRef<SceneTask>();
-			updateScore->SetUpdateFunction([&](SceneTask& self, const Time& time) {
-				constexpr float duration = 3.0f;
-
-				float delta = std::min(1.0f, (time.Elapsed - self.GetStartTime().Elapsed) / duration);
+			if (m_InputEnabled && evt.KeyCode == GLFW_KEY_ENTER)
+			{
+				m_InputEnabled = false;
+				StartCoroutine(ESceneTaskEvent::PostRender, RunExit());
+			}
+		});
 
-				m_RingBonus(delta);
-				m_PerfectBonus(delta);
-				m_Score(delta);
+	}
 
-				if (delta == 1.0f)
-				{
-					Assets::GetInstance().Get<Audio>(AssetName::SfxTally)->Play();
-					m_InputEnabled = true;
-					self.SetDone();
-				}
+	SceneCoroutine StageClearScene::RunTally()
+	{
+		co_await Fade(glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f }, glm::vec4{ 1.0f, 1.0f, 1.0f, 0.0f }, 0.5f);
+		co_await WaitFor(2.5f);
 
-			});
-			ScheduleTask(ESceneTaskEvent::PostRender, updateScore);
-		});
-		ScheduleTask(ESceneTaskEvent::PostRender, waitForUpdate);
+		constexpr float duration = 3.0f;
 
+		for (float t = 0.0f; t < duration;)
+		{
+			Time time = co_await NextFrame();
+			t = std::min(duration, t + time.Delta);
 
-		// Input
-		AddSubscription(app.KeyReleased, [&](const KeyReleasedEvent& evt) {
+			float delta = t / duration;
+			m_RingBonus(delta);
+			m_PerfectBonus(delta);
+			m_Score(delta);
+		}
 
-			if (m_InputEnabled && evt.KeyCode == GLFW_KEY_ENTER)
-			{
-				auto fadeOut = MakeRef<FadeTask>(glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 0.5f);
-
-				fadeOut->SetDoneFunction([&](SceneTask& self) {
-					if (m_GameInfo.Mode == GameMode::BlueSpheres)
-					{
-						auto stageGenerator = Assets::GetInstance().Get<StageGenerator>(AssetName::StageGenerator);
-						auto newGameInfo = m_GameInfo;
-						newGameInfo.CurrentStage = m_NextStage;
-						newGameInfo.Score = m_Score.Get<1>();
-						auto stage = stageGenerator->Generate(stageGenerator->GetCodeFromStage(newGameInfo.CurrentStage));
-						auto scene = MakeRef<GameScene>(stage, newGameInfo);
-						GetApplication().GotoScene(scene);
-					}
-					else
-					{
-						GetApplication().GotoScene(MakeRef<SplashScene>());
-					}
-				});
-
-				ScheduleTask(ESceneTaskEvent::PostRender, fadeOut);
+		Assets::GetInstance().Get<Audio>(AssetName::SfxTally)->Play();
+		m_InputEnabled = true;
+	}
 
-			}
-		});
+	SceneCoroutine StageClearScene::RunExit()
+	{
+		co_await Fade(glm::vec4(1.0f, 1.0f, 1.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 0.5f);
 
+		if (m_GameInfo.Mode == GameMode::BlueSpheres)
+		{
+			auto stageGenerator = Assets::GetInstance().Get<StageGenerator>(AssetName::StageGenerator);
+			auto newGameInfo = m_GameInfo;
+			newGameInfo.CurrentStage = m_NextStage;
+			newGameInfo.Score = m_Score.Get<1>();
+			auto stage = stageGenerator->Generate(stageGenerator->GetCodeFromStage(newGameInfo.CurrentStage));
+			auto scene = MakeRef<GameScene>(stage, newGameInfo);
+			GetApplication().GotoScene(scene);
+		}
+		else
+		{
+			GetApplication().GotoScene(MakeRef<SplashScene>());
+		}
 	}
 
 	void StageClearScene::OnRender(const Time& time)
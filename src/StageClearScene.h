@@ -4,6 +4,7 @@
 
 #include "EventEmitter.h"
 #include "Scene.h"
+#include "SceneCoroutine.h"
 #include "Ref.h"
 #include "Common.h"
 #include "StageCodeHelper.h"
@@ -27,6 +28,8 @@ namespace bsf
 		void OnAttach() override;
 		void OnRender(const Time& time) override;
 		void OnDetach() override;
+		// The fade and the tally run as coroutines
+		bool IsAnimating() const override { return false; }
 	private:
 
 		bool m_InputEnabled = false;
@@ -40,6 +43,9 @@ namespace bsf
 		InterpolatedValue<uint64_t> m_Score;
 
 		void RenderUI();
+
+		SceneCoroutine RunTally();
+		SceneCoroutine RunExit();
 	};
 }
 
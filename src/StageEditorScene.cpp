@@ -4,6 +4,9 @@
 #include "MenuScene.h"
 #include "Assets.h"
 #include "Texture.h"
+#include "Framebuffer.h"
+#include "ShaderProgram.h"
+#include "VertexArray.h"
 #include "Renderer2D.h"
 #include "Application.h"
 #include "Font.h"
@@ -684,6 +687,12 @@ namespace bsf
 		return m_Flags && static_cast<std::underlying_type_t<UIElementFlags>>(flag);
 	}
 
+	void UIElement::Invalidate()
+	{
+		if (m_Root)
+			m_Root->Invalidate();
+	}
+
 	const std::vector<Ref<UIElement>>& UIElement::Children()
 	{
 		static const std::vector<Ref<UIElement>> s_Empty;
@@ -711,16 +720,19 @@ namespace bsf
 		m_App = &app;
 
 		AddSubscription(app.CharacterTyped, [&](const CharacterTypedEvent& evt) {
+			Invalidate();
 			if (m_FocusedControl)
 				m_FocusedControl->CharacterTyped.Emit(evt);
 		});
 
 		AddSubscription(app.KeyPressed, [&](const KeyPressedEvent& evt) {
+			Invalidate();
 			if (m_FocusedControl)
 				m_FocusedControl->KeyPressed.Emit(evt);
 		});
 
 		AddSubscription(app.KeyReleased, [&](const KeyReleasedEvent& evt) {
+			Invalidate();
 			if (m_FocusedControl)
 				m_FocusedControl->KeyReleased.Emit(evt);
 		});
@@ -731,6 +743,8 @@ namespace bsf
 
 			glm::vec2 pos = GetMousePosition({ evt.X,evt.Y });
 
+			auto prevHoverTarget = std::move(m_MouseState.HoverTarget);
+
 			m_MouseState.PrevPosition = m_MouseState.Position;
 			m_MouseState.Position = pos;
 			m_MouseState.HoverTarget = nullptr;
@@ -757,11 +771,16 @@ namespace bsf
 
 			}
 
+			// Plain cursor moves only change the overlays
+			if (m_MouseState.DragTarget || m_MouseState.HoverTarget != prevHoverTarget)
+				Invalidate();
+
 		});
 
 		AddSubscription(app.Wheel, [&](const WheelEvent& evt) {
 			if (m_MouseState.HoverTarget)
 			{
+				Invalidate();
 				auto pos = GetMousePosition({ evt.X, evt.Y });
 				m_MouseState.HoverTarget->Wheel.Emit({ evt.DeltaX, evt.DeltaY, pos.x, pos.y });
 			}
@@ -773,6 +792,8 @@ namespace bsf
 
 			glm::vec2 pos = GetMousePosition({ evt.X,evt.Y });
 
+			Invalidate();
+
 			m_MouseState.Position = pos;
 			m_MouseState.PrevPosition = pos;
 
@@ -812,6 +833,8 @@ namespace bsf
 
 			glm::vec2 pos = GetMousePosition({ evt.X,evt.Y });
 
+			Invalidate();
+
 			m_MouseState.DragTarget = nullptr;
 			m_MouseState.Position = pos;
 			m_MouseState.PrevPosition = pos;
@@ -853,11 +876,17 @@ namespace bsf
 	{
 		auto font = Assets::GetInstance().Get<Font>(AssetName::FontMain);
 
+		if (windowSize != m_WindowSize || viewport != m_Viewport)
+			Invalidate();
+
 		m_WindowSize = windowSize;
 		m_Viewport = viewport;
 		m_Projection = glm::ortho(0.0f, viewport.x, 0.0f, viewport.y, -1.0f, 1.0f);
 		m_InverseProjection = glm::inverse(m_Projection);
 
+		if (m_LayersToPop > 0 || !m_LayersToPush.empty())
+			Invalidate();
+
 		for (uint32_t i = 0; i < m_LayersToPop; ++i)
 			m_Layers.pop_back();
 		m_LayersToPop = 0;
@@ -867,25 +896,82 @@ namespace bsf
 
 		m_Style.Recompute();
 
-		r2.Begin(m_Projection);
-
-		r2.TextShadowColor(m_Style.ShadowColor);
-		r2.TextShadowOffset({ m_Style.TextShadowOffset, -m_Style.TextShadowOffset });
-
 		for (auto& layer : m_Layers)
 		{
 			layer->Traverse([&](UIElement& el) {
 				el.m_Style = &m_Style;
 				el.m_App = m_App;
+				el.m_Root = this;
 			});
 			layer->Update(*this, time);
 			layer->UpdateBounds(*this, { 0.0f, 0.0f }, viewport);
-			layer->Render(*this, r2, time);
+		}
+
+		// Render the layers again only if something changed since the last time
+		const uint32_t cacheWidth = (uint32_t)windowSize.x, cacheHeight = (uint32_t)windowSize.y;
+
+		if (m_Cache == nullptr)
+		{
+			m_Cache = MakeRef<Framebuffer>(cacheWidth, cacheHeight, false);
+			m_Cache->CreateColorAttachment("color", GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE);
+			m_Dirty = true;
+		}
+		else if (m_Cache->GetWidth() != cacheWidth || m_Cache->GetHeight() != cacheHeight)
+		{
+			m_Cache->Resize(cacheWidth, cacheHeight);
+			m_Dirty = true;
+		}
+
+		if (m_Dirty)
+		{
+			BSF_DIAGNOSTIC_SCOPE("UIRoot Cache");
+
+			// Elements can invalidate again while rendering, if they're still animating
+			m_Dirty = false;
+
+			m_Cache->Bind();
+
+			// With the clear color the scene has cleared the window with
+			glClear(GL_COLOR_BUFFER_BIT);
+
+			r2.Begin(m_Projection);
+
+			r2.TextShadowColor(m_Style.ShadowColor);
+			r2.TextShadowOffset({ m_Style.TextShadowOffset, -m_Style.TextShadowOffset });
+
+			for (size_t i = 0; i < m_Layers.size(); ++i)
+			{
+				auto& layer = m_Layers[i];
+
+				layer->Render(*this, r2, time);
+
+				// Overlays of the layers below the top one would end up over it, they're frozen instead
+				if (i + 1 < m_Layers.size())
+					layer->Traverse([&](UIElement& el) { el.RenderOverlay(*this, r2, time); });
+
 #ifdef BSF_ENABLE_DIAGNOSTIC
-			//layer->Traverse([&](UIElement& el) { el.RenderDebugInfo(*this, r2, time); });
+				//layer->Traverse([&](UIElement& el) { el.RenderDebugInfo(*this, r2, time); });
 #endif
+			}
+
+			r2.End();
+
+			m_Cache->Unbind();
 		}
 
+		r2.Begin(m_Projection);
+
+		r2.TextShadowColor(m_Style.ShadowColor);
+		r2.TextShadowOffset({ m_Style.TextShadowOffset, -m_Style.TextShadowOffset });
+
+		r2.Push();
+		r2.Texture(m_Cache->GetColorAttachment("color"));
+		r2.DrawQuad({ 0.0f, 0.0f }, viewport);
+		r2.Pop();
+
+		if (!m_Layers.empty())
+			m_Layers.back()->Traverse([&](UIElement& el) { el.RenderOverlay(*this, r2, time); });
+
 		r2.Push();
 		r2.Pivot(EPivot::Left);
 		r2.Translate({ (viewport.x - m_Style.ToastWidth) / 2.0f, m_Style.GetMargin(2.0f) + 0.5f });
@@ -966,27 +1052,34 @@ namespace bsf
 	}
 
 
+	static const std::unordered_map<StageEditorTool, EStageObject> s_toolMap = {
+		{ StageEditorTool::BlueSphere,		EStageObject::BlueSphere },
+		{ StageEditorTool::RedSphere,		EStageObject::RedSphere },
+		{ StageEditorTool::YellowSphere,	EStageObject::YellowSphere },
+		{ StageEditorTool::Bumper,			EStageObject::Bumper },
+		{ StageEditorTool::Ring,			EStageObject::Ring },
+		{ StageEditorTool::GreenSphere,		EStageObject::GreenSphere}
+	};
+
 	UIStageEditorArea::UIStageEditorArea() : UIElement(MakeFlags(UIElementFlags::ReceiveHover))
 	{
 		auto& assets = Assets::GetInstance();
 
-		static const std::unordered_map<StageEditorTool, EStageObject> s_toolMap = {
-			{ StageEditorTool::BlueSphere,		EStageObject::BlueSphere },
-			{ StageEditorTool::RedSphere,		EStageObject::RedSphere },
-			{ StageEditorTool::YellowSphere,	EStageObject::YellowSphere },
-			{ StageEditorTool::Bumper,			EStageObject::Bumper },
-			{ StageEditorTool::Ring,			EStageObject::Ring },
-			{ StageEditorTool::GreenSphere,		EStageObject::GreenSphere}
-		};
+		m_SphereSprite = assets.Get<Texture2D>(AssetName::TexUISphere);
+		m_RingSprite = assets.Get<Texture2D>(AssetName::TexUIRing);
 
-		m_StageObjRendering = {
-			{ EStageObject::BlueSphere,		{ assets.Get<Texture2D>(AssetName::TexUISphere),	Colors::BlueSphere }},
-			{ EStageObject::RedSphere,		{ assets.Get<Texture2D>(AssetName::TexUISphere),	Colors::RedSphere }},
-			{ EStageObject::GreenSphere,	{ assets.Get<Texture2D>(AssetName::TexUISphere),	Colors::GreenSphere }},
-			{ EStageObject::YellowSphere,	{ assets.Get<Texture2D>(AssetName::TexUISphere),	Colors::YellowSphere }},
-			{ EStageObject::Bumper,			{ assets.Get<Texture2D>(AssetName::TexUISphere),	Colors::White }},
-			{ EStageObject::Ring,			{ assets.Get<Texture2D>(AssetName::TexUIRing),		Colors::Ring }}
-		};
+		m_StageObjColors.fill(Colors::Transparent);
+		m_StageObjColors[(size_t)EStageObject::BlueSphere] = Colors::BlueSphere;
+		m_StageObjColors[(size_t)EStageObject::RedSphere] = Colors::RedSphere;
+		m_StageObjColors[(size_t)EStageObject::GreenSphere] = Colors::GreenSphere;
+		m_StageObjColors[(size_t)EStageObject::YellowSphere] = Colors::YellowSphere;
+		m_StageObjColors[(size_t)EStageObject::Bumper] = Colors::White;
+		m_StageObjColors[(size_t)EStageObject::Ring] = Colors::Ring;
+
+		m_StageMap = MakeRef<Texture2D>(GL_RG8UI, GL_RG_INTEGER, GL_UNSIGNED_BYTE);
+		m_StageMap->SetFilter(TextureFilter::Nearest, TextureFilter::Nearest);
+
+		m_pTilemap = ShaderProgram::FromFile("assets/shaders/stage_tilemap.vert", "assets/shaders/stage_tilemap.frag");
 
 		m_Pattern = CreateCheckerBoard({ 0, 0 });
 		m_BgPattern = CreateCheckerBoard({ 0xffffffff, 0xffcccccc });
@@ -995,44 +1088,21 @@ namespace bsf
 		m_PositionRendering = { assets.Get<Texture2D>(AssetName::TexUIPosition), Colors::White };
 
 		auto editCallback = [&](const MouseEvent& evt) {
-
-			if (auto stageCoordsOpt = ScreenToStage({ evt.X, evt.Y }); stageCoordsOpt.has_value())
-			{
-				const auto& stageCoords = stageCoordsOpt.value();
-
-				if (evt.Button == MouseButton::Left && !GetApplication().GetKeyPressed(GLFW_KEY_SPACE))
-				{
-					if (auto obj = s_toolMap.find(ActiveTool); obj != s_toolMap.end())
-					{
-						m_Stage->SetValueAt(stageCoords.x, stageCoords.y, obj->second);
-					}
-					else if (ActiveTool == StageEditorTool::AvoidSearch)
-					{
-						m_Stage->SetAvoidSearchAt(stageCoords.x, stageCoords.y, EAvoidSearch::Yes);
-					}
-					else if (ActiveTool == StageEditorTool::Position)
-					{
-						if (m_Stage->StartPoint == stageCoords)
-							m_Stage->StartDirection = { -m_Stage->StartDirection.y, m_Stage->StartDirection.x };
-
-						m_Stage->StartPoint = stageCoords;
-
-					}
-
-				}
-				else if (evt.Button == MouseButton::Right)
-				{
-					m_Stage->SetValueAt(stageCoords.x, stageCoords.y, EStageObject::None);
-					m_Stage->SetAvoidSearchAt(stageCoords.x, stageCoords.y, EAvoidSearch::No);
-				}
-			}
+			if (auto stageCoords = ScreenToStage({ evt.X, evt.Y }); stageCoords.has_value())
+				EditCell(stageCoords.value(), evt.Button);
 		};
 
 		AddSubscription(MouseMoved, [&](const MouseEvent& evt) {
 			m_CursorPos = ScreenToStage({ evt.X,evt.Y });
 		});
 		AddSubscription(MouseClicked, editCallback);
-		AddSubscription(MouseDragged, editCallback);
+		AddSubscription(MouseDragged, [&, editCallback](const MouseEvent& evt) {
+			// There's one drag event per frame, strokes paint all the cells crossed since the previous one
+			if (evt.Button == MouseButton::Right || (evt.Button == MouseButton::Left && ActiveTool != StageEditorTool::Position))
+				EditLine(ScreenToWorld({ evt.X - evt.DeltaX, evt.Y - evt.DeltaY }), ScreenToWorld({ evt.X, evt.Y }), evt.Button);
+			else
+				editCallback(evt);
+		});
 		AddSubscription(MouseDragged, [&](const MouseEvent& evt) {
 			if (evt.Button == MouseButton::Middle || (evt.Button == MouseButton::Left && GetApplication().GetKeyPressed(GLFW_KEY_SPACE)))
 				m_ViewOrigin -= glm::vec2(evt.DeltaX, evt.DeltaY) / m_Zoom;
@@ -1049,12 +1119,23 @@ namespace bsf
 
 	void UIStageEditorArea::Update(const UIRoot& root, const Time& time)
 	{
-		float zoomSpeed = std::max(0.5f, std::abs(m_Zoom - m_TargetZoom)) * 4.0f;
-		auto prevPos = ScreenToWorld(root.GetMousePosition());
-		m_Zoom = MoveTowards(m_Zoom, m_TargetZoom, time.Delta * zoomSpeed);
-		auto nextPos = ScreenToWorld(root.GetMousePosition());
+		if (m_Zoom != m_TargetZoom)
+		{
+			float zoomSpeed = std::max(0.5f, std::abs(m_Zoom - m_TargetZoom)) * 4.0f;
+			auto prevPos = ScreenToWorld(root.GetMousePosition());
+			m_Zoom = MoveTowards(m_Zoom, m_TargetZoom, time.Delta * zoomSpeed);
+			auto nextPos = ScreenToWorld(root.GetMousePosition());
+
+			m_ViewOrigin += prevPos - nextPos;
 
-		m_ViewOrigin += prevPos - nextPos;
+			Invalidate();
+		}
+
+		if (m_Stage && m_Stage->GetRevision() != m_StageRevision)
+		{
+			m_StageRevision = m_Stage->GetRevision();
+			Invalidate();
+		}
 
 		// Update pattern texture
 		UpdatePattern();
@@ -1068,58 +1149,61 @@ namespace bsf
 		{
 			auto& style = GetStyle();
 			auto& assets = Assets::GetInstance();
-			auto size = glm::vec2(m_Stage->GetSize(), m_Stage->GetSize()) * m_Zoom;
-			auto tiling = glm::vec2(m_Stage->GetSize(), m_Stage->GetSize()) / 2.0f;
-			auto texWhite = assets.Get<Texture2D>(AssetName::TexWhite);
+			const auto& [avoidSearchSprite, avoidSearchTint] = m_AvoidSearchRendering;
 
-			r2.Push();
-
-			r2.Clip(Bounds);
+			UpdateStageMap();
 
+			// The whole area is a single quad with its own program, what's been batched so far goes first
+			r2.End();
 
-			r2.Texture(m_BgPattern);
-			r2.Color(style.GetBackgroundColor(*this, style.Palette.Background));
-			r2.DrawQuad(Bounds.Position, Bounds.Size, Bounds.Size / (m_Zoom * 2.0f), m_ViewOrigin / 2.0f + glm::vec2(0.25f));
+			GLEnableScope scope({ GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE });
+			glDisable(GL_BLEND);
+			glDisable(GL_DEPTH_TEST);
+			glDisable(GL_CULL_FACE);
 
-			r2.Color({ 1.0f, 1.0f, 1.0f, 1.0f });
-			r2.Texture(m_Pattern);
-			r2.DrawQuad(WorldToScreen({ 0, 0 }), size, tiling, { -0.25f, -0.25f });
+			auto spriteRect = [](const Ref<Texture2D>& sprite) -> std::array<float, 4> {
+				return { sprite->GetUvOffset().x, sprite->GetUvOffset().y, sprite->GetUvScale().x, sprite->GetUvScale().y };
+			};
 
+			m_pTilemap->Use();
 
-			glm::uvec2 bl = glm::clamp(glm::floor(ScreenToWorld(Bounds.Position)), 0.0f, (float)m_Stage->GetSize());
-			glm::uvec2 tr = glm::clamp(glm::ceil(ScreenToWorld(Bounds.Position + Bounds.Size)), 0.0f, (float)m_Stage->GetSize());
+			m_pTilemap->UniformMatrix4f(HS("uProjection"), root.GetProjection());
+			m_pTilemap->Uniform4f(HS("uBounds"), { Bounds.Position.x, Bounds.Position.y, Bounds.Size.x, Bounds.Size.y });
+			m_pTilemap->Uniform2f(HS("uViewOrigin"), { m_ViewOrigin.x, m_ViewOrigin.y });
+			m_pTilemap->Uniform1f(HS("uZoom"), { m_Zoom });
 
-			for (uint32_t x = bl.x; x < tr.x; ++x)
-			{
-				for (uint32_t y = bl.y; y < tr.y; ++y)
-				{
+			m_pTilemap->UniformTexture(HS("uStage"), m_StageMap);
+			m_pTilemap->Uniform1i(HS("uStageSize"), { m_Stage->GetSize() });
 
-					if (auto obj = m_StageObjRendering.find(m_Stage->GetValueAt(x, y)); obj != m_StageObjRendering.end())
-					{
-						r2.Texture(std::get<0>(obj->second));
+			m_pTilemap->UniformTexture(HS("uBackground"), m_BgPattern);
+			m_pTilemap->Uniform4fv(HS("uBackgroundColor"), 1, glm::value_ptr(style.GetBackgroundColor(*this, style.Palette.Background)));
+			m_pTilemap->UniformTexture(HS("uPattern"), m_Pattern);
 
-						r2.Color(style.ShadowColor);
-						r2.DrawQuad(WorldToScreen({ x + style.ShadowOffset, y - style.ShadowOffset }), { m_Zoom, m_Zoom });
+			m_pTilemap->UniformTexture(HS("uSphere"), m_SphereSprite);
+			m_pTilemap->Uniform4f(HS("uSphereRect"), spriteRect(m_SphereSprite));
+			m_pTilemap->UniformTexture(HS("uRing"), m_RingSprite);
+			m_pTilemap->Uniform4f(HS("uRingRect"), spriteRect(m_RingSprite));
+			m_pTilemap->UniformTexture(HS("uAvoidSearch"), avoidSearchSprite);
+			m_pTilemap->Uniform4f(HS("uAvoidSearchRect"), spriteRect(avoidSearchSprite));
 
-						r2.Color(std::get<1>(obj->second));
-						r2.DrawQuad(WorldToScreen({ x, y }), { m_Zoom, m_Zoom });
-					}
+			m_pTilemap->Uniform4fv(HS("uObjectColors[0]"), (uint32_t)m_StageObjColors.size(), glm::value_ptr(m_StageObjColors[0]));
+			m_pTilemap->Uniform4fv(HS("uAvoidSearchColor"), 1, glm::value_ptr(avoidSearchTint));
+			m_pTilemap->Uniform4fv(HS("uShadowColor"), 1, glm::value_ptr(style.ShadowColor));
+			m_pTilemap->Uniform2f(HS("uShadowOffset"), { style.ShadowOffset, -style.ShadowOffset });
 
-					if (m_Stage->GetAvoidSearchAt(x, y) == EAvoidSearch::Yes)
-					{
-						r2.Push();
-						r2.Texture(std::get<0>(m_AvoidSearchRendering));
-						r2.Color(style.ShadowColor);
-						r2.DrawQuad(WorldToScreen({ x + style.ShadowOffset, y - style.ShadowOffset }), { m_Zoom, m_Zoom });
+			assets.Get<VertexArray>(AssetName::ModClipSpaceQuad)->DrawArrays(GL_TRIANGLES);
+		}
+	}
 
-						r2.Color(std::get<1>(m_AvoidSearchRendering));
-						r2.DrawQuad(WorldToScreen({ x, y }), { m_Zoom, m_Zoom });
+	void UIStageEditorArea::RenderOverlay(const UIRoot& root, Renderer2D& r2, const Time& time)
+	{
+		if (m_Stage)
+		{
+			auto& style = GetStyle();
 
-						r2.Pop();
-					}
+			r2.Push();
 
-				}
-			}
+			r2.Clip(Bounds);
 
 			// Position
 			{
@@ -1150,7 +1234,6 @@ namespace bsf
 
 			DrawCursor(r2, style);
 
-
 			r2.Pop();
 		}
 	}
@@ -1160,14 +1243,46 @@ namespace bsf
 		Bounds = { origin, computedSize };
 	}
 
+	void UIStageEditorArea::UpdateStageMap()
+	{
+		if (m_StageMapRevision == m_Stage->GetRevision())
+			return;
+
+		const auto& data = m_Stage->GetData();
+		const auto& avoidSearch = m_Stage->GetAvoidSearch();
+		const uint32_t size = m_Stage->GetSize();
+
+		std::vector<glm::u8vec2> cells(data.size());
+
+		for (size_t i = 0; i < cells.size(); i++)
+			cells[i] = { (uint8_t)data[i], (uint8_t)avoidSearch[i] };
+
+		m_StageMap->SetPixels(cells.data(), size, size);
+		m_StageMapRevision = m_Stage->GetRevision();
+	}
+
+	void UIStageEditorArea::UpdateStageMap(const glm::ivec2& pos)
+	{
+		if (m_StageMapRevision == m_Stage->GetRevision())
+			return;
+
+		const glm::u8vec2 cell = { (uint8_t)m_Stage->GetValueAt(pos), (uint8_t)m_Stage->GetAvoidSearchAt(pos) };
+
+		m_StageMap->SetSubPixels(&cell, pos, { 1, 1 });
+		m_StageMapRevision = m_Stage->GetRevision();
+	}
+
 	void UIStageEditorArea::UpdatePattern()
 	{
-		if (m_Stage)
+		if (m_Stage && m_PatternColors != m_Stage->PatternColors)
 		{
 			m_Pattern = CreateCheckerBoard({
 				ToHexColor(m_Stage->PatternColors[0]),
 				ToHexColor(m_Stage->PatternColors[1])
 			}, m_Pattern);
+
+			m_PatternColors = m_Stage->PatternColors;
+			Invalidate();
 		}
 
 	}
@@ -1221,6 +1336,82 @@ namespace bsf
 		return m_ViewOrigin + (pos - Bounds.Position) / m_Zoom;
 	}
 
+	void UIStageEditorArea::EditCell(const glm::ivec2& stageCoords, MouseButton button)
+	{
+		if (m_Stage == nullptr || stageCoords.x < 0 || stageCoords.x >= m_Stage->GetSize()
+			|| stageCoords.y < 0 || stageCoords.y >= m_Stage->GetSize())
+			return;
+
+		// Edits of a stage the map is up to date with only need their own cell uploaded
+		const bool stageMapCurrent = m_StageMapRevision == m_Stage->GetRevision();
+
+		if (button == MouseButton::Left && !GetApplication().GetKeyPressed(GLFW_KEY_SPACE))
+		{
+			if (auto obj = s_toolMap.find(ActiveTool); obj != s_toolMap.end())
+			{
+				m_Stage->SetValueAt(stageCoords.x, stageCoords.y, obj->second);
+			}
+			else if (ActiveTool == StageEditorTool::AvoidSearch)
+			{
+				m_Stage->SetAvoidSearchAt(stageCoords.x, stageCoords.y, EAvoidSearch::Yes);
+			}
+			else if (ActiveTool == StageEditorTool::Position)
+			{
+				if (m_Stage->StartPoint == stageCoords)
+					m_Stage->StartDirection = { -m_Stage->StartDirection.y, m_Stage->StartDirection.x };
+
+				m_Stage->StartPoint = stageCoords;
+
+			}
+
+		}
+		else if (button == MouseButton::Right)
+		{
+			m_Stage->SetValueAt(stageCoords.x, stageCoords.y, EStageObject::None);
+			m_Stage->SetAvoidSearchAt(stageCoords.x, stageCoords.y, EAvoidSearch::No);
+		}
+
+		if (stageMapCurrent)
+			UpdateStageMap(stageCoords);
+	}
+
+	void UIStageEditorArea::EditLine(const glm::vec2& from, const glm::vec2& to, MouseButton button)
+	{
+		// Grid traversal (Amanatides & Woo): t is the distance along the segment, in
+		// units of its length, at which the next vertical and horizontal cell edges are crossed
+		constexpr float inf = std::numeric_limits<float>::infinity();
+
+		const glm::vec2 dir = to - from;
+		const glm::ivec2 last = glm::floor(to);
+		const glm::ivec2 step = { dir.x > 0.0f ? 1 : -1, dir.y > 0.0f ? 1 : -1 };
+		const glm::vec2 tDelta = { dir.x != 0.0f ? std::abs(1.0f / dir.x) : inf, dir.y != 0.0f ? std::abs(1.0f / dir.y) : inf };
+
+		glm::ivec2 cell = glm::floor(from);
+		glm::vec2 tMax = {
+			dir.x != 0.0f ? (step.x > 0 ? cell.x + 1.0f - from.x : from.x - cell.x) * tDelta.x : inf,
+			dir.y != 0.0f ? (step.y > 0 ? cell.y + 1.0f - from.y : from.y - cell.y) * tDelta.y : inf
+		};
+
+		EditCell(cell, button);
+
+		while (cell != last)
+		{
+			// Axes that already reached the last cell don't move, whatever rounding did to t
+			if (cell.y == last.y || (cell.x != last.x && tMax.x < tMax.y))
+			{
+				cell.x += step.x;
+				tMax.x += tDelta.x;
+			}
+			else
+			{
+				cell.y += step.y;
+				tMax.y += tDelta.y;
+			}
+
+			EditCell(cell, button);
+		}
+	}
+
 	std::optional<glm::ivec2> UIStageEditorArea::ScreenToStage(const glm::vec2 screenPos) const
 	{
 		glm::ivec2 localPos = glm::floor(ScreenToWorld(screenPos));
@@ -1811,6 +2002,9 @@ namespace bsf
 			info.CurrentBounds.Position = MoveTowards(info.CurrentBounds.Position, info.TargetBounds.Position, speed * time.Delta);
 			info.CurrentBounds.Size = MoveTowards(info.CurrentBounds.Size, info.TargetBounds.Size, speed);
 
+			if (info.CurrentBounds.Position != info.TargetBounds.Position || info.CurrentBounds.Size != info.TargetBounds.Size)
+				Invalidate();
+
 			if (!(info.Loaded && info.Visible))
 				continue;
 
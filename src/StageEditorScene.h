@@ -21,6 +21,8 @@ namespace bsf
 	class Application;
 	class Renderer2D;
 	class Texture2D;
+	class Framebuffer;
+	class ShaderProgram;
 
 	class UIPanel;
 	class UIElement;
@@ -159,6 +161,8 @@ namespace bsf
 		virtual void Update(const UIRoot& root, const Time& time) {}
 		virtual void UpdateBounds(const UIRoot& root, const glm::vec2& origin, const glm::vec2& computedSize) = 0;
 		virtual void Render(const UIRoot& root, Renderer2D& renderer, const Time& time) = 0;
+		// Drawn every frame on top of the retained UI, for content that changes without input
+		virtual void RenderOverlay(const UIRoot& root, Renderer2D& renderer, const Time& time) {}
 		void RenderDebugInfo(const UIRoot& root, Renderer2D& renderer, const Time& time);
 
 		uint32_t GetId() const { return m_Id; }
@@ -172,6 +176,9 @@ namespace bsf
 		const UIStyle& GetStyle() const { return *m_Style; }
 		const Application& GetApplication() const { return *m_App; }
 
+		// The UI is only rendered again after input, elements that change on their own call this
+		void Invalidate();
+
 	private:
 		friend class UIRoot;
 		static uint32_t m_NextId;
@@ -179,6 +186,7 @@ namespace bsf
 		std::underlying_type_t<UIElementFlags> m_Flags;
 		UIStyle* m_Style = nullptr;
 		Application* m_App = nullptr;
+		UIRoot* m_Root = nullptr;
 		uint32_t m_Id;
 	};
 
@@ -201,6 +209,12 @@ namespace bsf
 		void ShowToast(const UIToast& toast) { m_Toasts.push_front(toast); }
 
 		glm::vec2 GetMousePosition() const { return m_MouseState.Position; }
+		const glm::mat4& GetProjection() const { return m_Projection; }
+
+		void Invalidate() { m_Dirty = true; }
+
+		// Elements invalidate the cache while they move, toasts fade out
+		bool IsAnimating() const { return m_Dirty || !m_Toasts.empty() || !m_LayersToPush.empty() || m_LayersToPop > 0; }
 
 	private:
 
@@ -216,6 +230,10 @@ namespace bsf
 		std::list<UIToast> m_Toasts;
 		uint32_t m_LayersToPop = 0;
 
+		// Layers are rendered here when something changes, the overlays and the toasts every frame
+		Ref<Framebuffer> m_Cache = nullptr;
+		bool m_Dirty = true;
+
 		struct MouseButtonState
 		{
 			MouseButtonState() = default;
@@ -364,25 +382,40 @@ namespace bsf
 
 		void Update(const UIRoot& root, const Time& time) override;
 		void Render(const UIRoot& root, Renderer2D& renderer, const Time& time) override;
+		void RenderOverlay(const UIRoot& root, Renderer2D& renderer, const Time& time) override;
 		void UpdateBounds(const UIRoot& root, const glm::vec2& origin, const glm::vec2& computedSize) override;
 
-		void SetStage(const Ref<Stage>& stage) { m_Stage = stage; }
+		void SetStage(const Ref<Stage>& stage) { m_Stage = stage; Invalidate(); }
 		void UpdatePattern();
 
 	private:
 
 		void DrawCursor(Renderer2D& r2, const UIStyle& style);
 
+		void UpdateStageMap();
+		void UpdateStageMap(const glm::ivec2& pos);
+
+		void EditCell(const glm::ivec2& stageCoords, MouseButton button);
+		// Edits every cell crossed by the segment, in world coordinates
+		void EditLine(const glm::vec2& from, const glm::vec2& to, MouseButton button);
+
 		glm::vec2 WorldToScreen(const glm::vec2 pos) const;
 		glm::vec2 ScreenToWorld(const glm::vec2 pos) const;
 		std::optional<glm::ivec2> ScreenToStage(const glm::vec2 screenPos) const;
 
-		// StageObject: { Texture, Tint }
-		std::unordered_map<EStageObject, std::tuple<Ref<Texture2D>, glm::vec4>> m_StageObjRendering;
+		// Sprites of the tilemap shader, which uses the ring one for EStageObject::Ring
+		Ref<Texture2D> m_SphereSprite, m_RingSprite;
+		// StageObject tints, by EStageObject value
+		std::array<glm::vec4, 7> m_StageObjColors;
 		// Avoid search { Texture, Tint }
 		std::tuple<Ref<Texture2D>, glm::vec4> m_AvoidSearchRendering;
 		std::tuple<Ref<Texture2D>, glm::vec4> m_PositionRendering;
 
+		// The stage grid, one texel per cell: object in R, avoid search in G
+		Ref<Texture2D> m_StageMap = nullptr;
+		uint32_t m_StageMapRevision = 0;
+		Ref<ShaderProgram> m_pTilemap = nullptr;
+
 		float m_MinZoom = 0.25f, m_MaxZoom = 2.0f;
 
 		glm::vec2 m_ViewOrigin = { 0.0f, 0.0f };
@@ -392,6 +425,10 @@ namespace bsf
 
 		Ref<Stage> m_Stage = nullptr;
 		Ref<Texture2D> m_Pattern = nullptr, m_BgPattern;
+
+		// Stage state the retained UI has been rendered with
+		uint32_t m_StageRevision = 0;
+		std::optional<std::array<glm::vec3, 2>> m_PatternColors = std::nullopt;
 	};
 
 	class UITextInput : public UIElement
@@ -511,6 +548,7 @@ namespace bsf
 		void OnAttach() override;
 		void OnRender(const Time& time) override;
 		void OnDetach() override;
+		bool IsAnimating() const override { return m_uiRoot->IsAnimating(); }
 
 		~StageEditorScene() {}
 
@@ -13,6 +13,25 @@
 namespace bsf
 {
 
+	namespace
+	{
+		// Pixel rows are tightly packed, the default alignment of 4 would read past
+		// the end of rows that aren't a multiple of 4 bytes (e.g. RG8 with odd widths)
+		struct UnpackAlignmentScope
+		{
+			UnpackAlignmentScope()
+			{
+				glGetIntegerv(GL_UNPACK_ALIGNMENT, &m_SavedAlignment);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			}
+
+			~UnpackAlignmentScope() { glPixelStorei(GL_UNPACK_ALIGNMENT, m_SavedAlignment); }
+
+		private:
+			GLint m_SavedAlignment = 4;
+		};
+	}
+
 	std::tuple<std::vector<std::byte>, uint32_t, uint32_t> ImageLoad(std::string_view fileName, bool flipY)
 	{
 		std::ifstream is;
@@ -105,10 +124,30 @@ namespace bsf
 		Load(fileName);
 	}
 
+	Texture2D::Texture2D(const Ref<Texture2D>& page, const glm::uvec2& position, const glm::uvec2& size) :
+		Texture(page->GetId()),
+		m_InternalFormat(page->m_InternalFormat),
+		m_Format(page->m_Format),
+		m_Type(page->m_Type),
+		m_Page(page),
+		m_Size(size)
+	{
+		assert(!page->IsView());
+
+		const glm::vec2 pageSize = { page->GetWidth(), page->GetHeight() };
+		m_UvOffset = glm::vec2(position) / pageSize;
+		m_UvScale = glm::vec2(size) / pageSize;
+	}
+
 	Texture2D::Texture2D(Texture2D&& other) noexcept : Texture2D(other.m_InternalFormat, other.m_Format, other.m_Type)
 	{
 		m_Id = 0;
 		std::swap(m_Id, other.m_Id);
+		std::swap(m_Owned, other.m_Owned);
+		std::swap(m_Page, other.m_Page);
+		m_UvOffset = other.m_UvOffset;
+		m_UvScale = other.m_UvScale;
+		m_Size = other.m_Size;
 	}
 
 	void Texture2D::SetPixels(const void* pixels, uint32_t width, uint32_t height)
@@ -118,12 +157,23 @@ namespace bsf
 
 	void Texture2D::SetPixels(const void* pixels, uint32_t width, uint32_t height, uint32_t level)
 	{
+		assert(!IsView());
 		Bind(0);
+		UnpackAlignmentScope alignment;
 		BSF_GLCALL(glTexImage2D(GL_TEXTURE_2D, level, m_InternalFormat, width, height, 0, m_Format, m_Type, pixels));
 	}
 
+	void Texture2D::SetSubPixels(const void* pixels, const glm::uvec2& position, const glm::uvec2& size)
+	{
+		assert(!IsView());
+		Bind(0);
+		UnpackAlignmentScope alignment;
+		BSF_GLCALL(glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, size.x, size.y, m_Format, m_Type, pixels));
+	}
+
 	void Texture2D::SetFilter(TextureFilter minFilter, TextureFilter magFilter)
 	{
+		assert(!IsView()); // Would change the whole page
 
 		Bind(0);
 		BSF_GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, s_glTextureFilter.Get<0, 1>(minFilter)));
@@ -137,14 +187,23 @@ namespace bsf
 
 	void Texture2D::SetWrap(TextureWrap wrap)
 	{
+		assert(!IsView());
 		Bind(0);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, s_glTextureWrap.Get<0, 1>(wrap));
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, s_glTextureWrap.Get<0, 1>(wrap));
 	}
 
+	void Texture2D::SetMaxLevel(uint32_t level)
+	{
+		assert(!IsView());
+		Bind(0);
+		BSF_GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)level));
+	}
+
 
 	void Texture2D::Bind(uint32_t textureUnit) const
 	{
+		BSF_GLSTAT(TextureBinds);
 		BSF_GLCALL(glActiveTexture(GL_TEXTURE0 + textureUnit));
 		BSF_GLCALL(glBindTexture(GL_TEXTURE_2D, m_Id));
 	}
@@ -157,6 +216,9 @@ namespace bsf
 
 	uint32_t Texture2D::GetWidth() const
 	{
+		if (IsView())
+			return m_Size.x;
+
 		GLint width;
 		Bind(0);
 		BSF_GLCALL(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width));
@@ -165,6 +227,9 @@ namespace bsf
 
 	uint32_t Texture2D::GetHeight() const
 	{
+		if (IsView())
+			return m_Size.y;
+
 		GLint height;
 		Bind(0);
 		BSF_GLCALL(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height));
@@ -194,9 +259,15 @@ namespace bsf
 		BSF_DEBUG("Create texture id: {0}", m_Id);
 	}
 
+	Texture::Texture(uint32_t sharedId) :
+		m_Id(sharedId),
+		m_Owned(false)
+	{
+	}
+
 	Texture::~Texture()
 	{
-		if (m_Id != 0)
+		if (m_Id != 0 && m_Owned)
 		{
 			BSF_DEBUG("Delete texture id: {0}", m_Id);
 			BSF_GLCALL(glDeleteTextures(1, &m_Id));
@@ -295,6 +366,7 @@ namespace bsf
 
 	void TextureCube::Bind(uint32_t textureUnit) const
 	{
+		BSF_GLSTAT(TextureBinds);
 		BSF_GLCALL(glActiveTexture(GL_TEXTURE0 + textureUnit));
 		BSF_GLCALL(glBindTexture(GL_TEXTURE_CUBE_MAP, m_Id));
 	}
@@ -6,6 +6,8 @@
 #include <string_view>
 #include <vector>
 
+#include <glm/glm.hpp>
+
 
 namespace bsf
 {
@@ -61,7 +63,11 @@ namespace bsf
 
 	protected:
 
+		// Doesn't create a GL texture, the id belongs to another texture
+		explicit Texture(uint32_t sharedId);
+
 		uint32_t m_Id;
+		bool m_Owned = true;
 	};
 
 	
@@ -99,14 +105,20 @@ namespace bsf
 		Texture2D(uint32_t color);
 		Texture2D(std::string_view fileName);
 
+		// View of a sub-rect of another texture (an atlas page). Binding the view binds
+		// the page, UVs in [0, 1] are mapped to the sub-rect by GetUvOffset and GetUvScale
+		Texture2D(const Ref<Texture2D>& page, const glm::uvec2& position, const glm::uvec2& size);
+
 		Texture2D(const Texture2D&) = delete;
 		Texture2D(Texture2D&&) noexcept;
 
 		void SetPixels(const void* pixels, uint32_t width, uint32_t height);
 		void SetPixels(const void * pixels, uint32_t width, uint32_t height, uint32_t level);
+		void SetSubPixels(const void* pixels, const glm::uvec2& position, const glm::uvec2& size);
 
 		void SetFilter(TextureFilter minFilter, TextureFilter magFilter) override;
 		void SetWrap(TextureWrap wrap);
+		void SetMaxLevel(uint32_t level);
 
 		void Bind(uint32_t textureUnit) const override;
 
@@ -118,11 +130,21 @@ namespace bsf
 		GLenum GetInternalFormat() const { return m_InternalFormat; }
 		GLenum GetFormat() const { return m_Format; }
 		GLenum GetType() const { return m_Type; }
+
+		bool IsView() const { return m_Page != nullptr; }
+		const Ref<Texture2D>& GetPage() const { return m_Page; }
+		const glm::vec2& GetUvOffset() const { return m_UvOffset; }
+		const glm::vec2& GetUvScale() const { return m_UvScale; }
 	
 	private:
 
 		GLenum m_InternalFormat, m_Format, m_Type;
 
+		// Views only
+		Ref<Texture2D> m_Page = nullptr;
+		glm::vec2 m_UvOffset = { 0.0f, 0.0f }, m_UvScale = { 1.0f, 1.0f };
+		glm::uvec2 m_Size = { 0, 0 };
+
 		bool Load(std::string_view fileName);
 
 	};
@@ -0,0 +1,164 @@
+#include "BsfPch.h"
+
+#include "TextureAtlas.h"
+#include "Log.h"
+
+namespace bsf
+{
+	static constexpr uint32_t s_PageSize = 2048;
+	static constexpr uint32_t s_MaxRegionSize = 512; // Bigger images get their own texture
+
+	// Cells are aligned to the footprint of a texel of the last mip level and padded
+	// with copies of the image border, so no level samples the neighbouring images
+	static constexpr uint32_t s_MaxMipLevel = 3;
+	static constexpr uint32_t s_Padding = 1 << s_MaxMipLevel;
+
+	static uint32_t AlignToPadding(uint32_t value)
+	{
+		return (value + s_Padding - 1) & ~(s_Padding - 1);
+	}
+
+	uint32_t TextureAtlas::Add(std::string_view fileName)
+	{
+		auto [pixels, width, height] = ImageLoad(fileName, true);
+		return Add(std::move(pixels), width, height);
+	}
+
+	uint32_t TextureAtlas::Add(std::vector<std::byte>&& pixels, uint32_t width, uint32_t height)
+	{
+		assert(m_Textures.empty()); // Already built
+
+		if (pixels.empty()) // The image failed to load, keep the index valid anyway
+		{
+			pixels.resize(4, std::byte{ 0 });
+			width = height = 1;
+		}
+
+		assert(pixels.size() == size_t(width) * height * 4);
+
+		m_Images.push_back({ std::move(pixels), width, height });
+		return uint32_t(m_Images.size() - 1);
+	}
+
+	void TextureAtlas::Build(TextureFilter minFilter, TextureFilter magFilter)
+	{
+		assert(m_Textures.empty());
+
+		const auto isPacked = [](const Image& image) {
+			return image.Width <= s_MaxRegionSize && image.Height <= s_MaxRegionSize;
+		};
+
+		const auto cellSize = [](const Image& image) {
+			return glm::uvec2(AlignToPadding(image.Width), AlignToPadding(image.Height)) + 2u * s_Padding;
+		};
+
+		// Shelf packing, tallest images first so the shelves waste little space
+		std::vector<uint32_t> order(m_Images.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return m_Images[a].Height > m_Images[b].Height; });
+
+		std::vector<glm::uvec2> pageSizes;
+		uint32_t x = 0, y = 0, shelfHeight = 0;
+
+		for (auto i : order)
+		{
+			auto& image = m_Images[i];
+
+			if (!isPacked(image))
+				continue;
+
+			const auto cell = cellSize(image);
+
+			if (x + cell.x > s_PageSize)
+			{
+				x = 0;
+				y += shelfHeight;
+				shelfHeight = 0;
+			}
+
+			if (pageSizes.empty() || y + cell.y > s_PageSize)
+			{
+				pageSizes.emplace_back(0, 0);
+				x = y = shelfHeight = 0;
+			}
+
+			image.Page = uint32_t(pageSizes.size() - 1);
+			image.Position = { x, y };
+
+			x += cell.x;
+			shelfHeight = std::max(shelfHeight, cell.y);
+			pageSizes.back() = glm::max(pageSizes.back(), glm::uvec2(x, y + cell.y));
+		}
+
+		// Fill the pages
+		std::vector<std::vector<uint32_t>> pagePixels(pageSizes.size());
+
+		for (size_t p = 0; p < pageSizes.size(); p++)
+			pagePixels[p].resize(size_t(pageSizes[p].x) * pageSizes[p].y, 0);
+
+		for (const auto& image : m_Images)
+		{
+			if (!isPacked(image))
+				continue;
+
+			const auto cell = cellSize(image);
+			const auto pageWidth = pageSizes[image.Page].x;
+			const auto src = reinterpret_cast<const uint32_t*>(image.Pixels.data());
+			auto& dst = pagePixels[image.Page];
+
+			for (uint32_t cy = 0; cy < cell.y; cy++)
+			{
+				const uint32_t sy = uint32_t(std::clamp<int32_t>(int32_t(cy) - int32_t(s_Padding), 0, int32_t(image.Height) - 1));
+				auto row = dst.data() + size_t(image.Position.y + cy) * pageWidth + image.Position.x;
+
+				for (uint32_t cx = 0; cx < cell.x; cx++)
+				{
+					const uint32_t sx = uint32_t(std::clamp<int32_t>(int32_t(cx) - int32_t(s_Padding), 0, int32_t(image.Width) - 1));
+					row[cx] = src[size_t(sy) * image.Width + sx];
+				}
+			}
+		}
+
+		for (size_t p = 0; p < pageSizes.size(); p++)
+		{
+			auto page = MakeRef<Texture2D>(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+			page->SetPixels(pagePixels[p].data(), pageSizes[p].x, pageSizes[p].y);
+			page->SetWrap(TextureWrap::ClampToEdge);
+			page->SetMaxLevel(s_MaxMipLevel);
+			page->SetFilter(minFilter, magFilter);
+			m_Pages.push_back(page);
+		}
+
+		// Views and standalone textures
+		m_Textures.reserve(m_Images.size());
+
+		for (auto& image : m_Images)
+		{
+			if (isPacked(image))
+			{
+				const auto position = image.Position + glm::uvec2(s_Padding);
+				m_Textures.push_back(MakeRef<Texture2D>(m_Pages[image.Page], position, glm::uvec2(image.Width, image.Height)));
+			}
+			else
+			{
+				auto texture = MakeRef<Texture2D>(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+				texture->SetPixels(image.Pixels.data(), image.Width, image.Height);
+				texture->SetFilter(minFilter, magFilter);
+				m_Textures.push_back(texture);
+			}
+
+			image.Pixels = {};
+		}
+
+		for (size_t p = 0; p < pageSizes.size(); p++)
+			BSF_INFO("Texture atlas page {0}: {1} x {2}", p, pageSizes[p].x, pageSizes[p].y);
+
+		BSF_INFO("Texture atlas: {0} images, {1} pages", m_Images.size(), m_Pages.size());
+	}
+
+	const Ref<Texture2D>& TextureAtlas::Get(uint32_t index) const
+	{
+		assert(index < m_Textures.size());
+		return m_Textures[index];
+	}
+}
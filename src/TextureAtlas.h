@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Ref.h"
+#include "Texture.h"
+
+#include <string_view>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace bsf
+{
+	// Packs small RGBA images into a few big textures (pages) at load time. Every image becomes
+	// a Texture2D view of its page, so Renderer2D draws all of them with the same texture unit.
+	// Images too big for an atlas get their own texture
+	class TextureAtlas
+	{
+	public:
+		// Returns the index to pass to Get after Build
+		uint32_t Add(std::string_view fileName);
+		uint32_t Add(std::vector<std::byte>&& pixels, uint32_t width, uint32_t height);
+
+		void Build(TextureFilter minFilter, TextureFilter magFilter);
+
+		const Ref<Texture2D>& Get(uint32_t index) const;
+		const std::vector<Ref<Texture2D>>& GetPages() const { return m_Pages; }
+
+	private:
+		struct Image
+		{
+			std::vector<std::byte> Pixels;
+			uint32_t Width, Height;
+			uint32_t Page = 0;
+			glm::uvec2 Position = { 0, 0 }; // Of the padded cell
+		};
+
+		std::vector<Image> m_Images;
+		std::vector<Ref<Texture2D>> m_Textures;
+		std::vector<Ref<Texture2D>> m_Pages;
+	};
+}
@@ -0,0 +1,183 @@
+#include "BsfPch.h"
+
+#include "Trace.h"
+#include "Log.h"
+
+namespace bsf
+{
+	using TraceClock = std::chrono::steady_clock;
+	static const TraceClock::time_point s_TraceEpoch = TraceClock::now();
+
+	TraceRecorder& TraceRecorder::Get()
+	{
+		static TraceRecorder instance;
+		return instance;
+	}
+
+	TraceRecorder::~TraceRecorder()
+	{
+		// No logging here, the logger may be already gone
+		Close();
+
+		for (auto& buffer : m_Buffers)
+		{
+			for (Chunk* chunk = buffer->Head; chunk != nullptr;)
+			{
+				Chunk* next = chunk->Next.load(std::memory_order_acquire);
+				delete chunk;
+				chunk = next;
+			}
+		}
+	}
+
+	bool TraceRecorder::Start(const std::string& path)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		if (m_File.is_open())
+			return true;
+
+		m_File.open(path, std::ios::out | std::ios::trunc);
+		if (!m_File.is_open())
+		{
+			BSF_ERROR("Can't open trace file {0}", path);
+			return false;
+		}
+
+		// Drop what was left from a previous capture (scopes still open when it was stopped)
+		Drain(false);
+
+		m_File << "[\n";
+		m_FirstEvent = true;
+		s_Enabled.store(true, std::memory_order_relaxed);
+
+		BSF_INFO("Trace capture started: {0}", path);
+		return true;
+	}
+
+	void TraceRecorder::Flush()
+	{
+		std::lock_guard lock(m_Mutex);
+
+		if (m_File.is_open())
+		{
+			Drain(true);
+			m_File.flush();
+		}
+	}
+
+	void TraceRecorder::Stop()
+	{
+		std::lock_guard lock(m_Mutex);
+
+		if (Close())
+			BSF_INFO("Trace capture stopped");
+	}
+
+	bool TraceRecorder::Close()
+	{
+		if (!m_File.is_open())
+			return false;
+
+		s_Enabled.store(false, std::memory_order_relaxed);
+		Drain(true);
+
+		m_File << "\n]\n";
+		m_File.close();
+		return true;
+	}
+
+	void TraceRecorder::Record(const char* name, ETracePhase phase)
+	{
+		Buffer& buffer = GetThreadBuffer();
+		Chunk* chunk = buffer.Tail;
+
+		uint32_t count = chunk->Count.load(std::memory_order_relaxed);
+
+		if (count == Chunk::Capacity)
+		{
+			// The chunk is complete once the next one is linked
+			Chunk* next = new Chunk();
+			chunk->Next.store(next, std::memory_order_release);
+			buffer.Tail = chunk = next;
+			count = 0;
+		}
+
+		const int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(TraceClock::now() - s_TraceEpoch).count();
+		chunk->Events[count] = { name, time, phase };
+		chunk->Count.store(count + 1, std::memory_order_release);
+	}
+
+	TraceRecorder::Buffer& TraceRecorder::GetThreadBuffer()
+	{
+		thread_local Buffer* buffer = nullptr;
+
+		if (buffer == nullptr)
+		{
+			auto& recorder = Get();
+			std::lock_guard lock(recorder.m_Mutex);
+
+			auto newBuffer = std::make_unique<Buffer>();
+			newBuffer->ThreadId = uint32_t(recorder.m_Buffers.size()) + 1;
+			newBuffer->Head = newBuffer->Tail = new Chunk();
+
+			buffer = newBuffer.get();
+			recorder.m_Buffers.push_back(std::move(newBuffer));
+		}
+
+		return *buffer;
+	}
+
+	void TraceRecorder::Drain(bool write)
+	{
+		for (auto& buffer : m_Buffers)
+		{
+			while (true)
+			{
+				Chunk* chunk = buffer->Head;
+
+				// Read next before count, if a next chunk exists this one is full
+				Chunk* next = chunk->Next.load(std::memory_order_acquire);
+				const uint32_t count = chunk->Count.load(std::memory_order_acquire);
+
+				if (write)
+				{
+					for (uint32_t i = buffer->Flushed; i < count; i++)
+						WriteEvent(chunk->Events[i], buffer->ThreadId);
+				}
+
+				buffer->Flushed = count;
+
+				if (next == nullptr)
+					break;
+
+				// The owner thread only writes to its tail, which is never this chunk
+				delete chunk;
+				buffer->Head = next;
+				buffer->Flushed = 0;
+			}
+		}
+	}
+
+	void TraceRecorder::WriteEvent(const Event& evt, uint32_t threadId)
+	{
+		fmt::memory_buffer out;
+
+		if (!m_FirstEvent)
+			fmt::format_to(std::back_inserter(out), ",\n");
+		m_FirstEvent = false;
+
+		fmt::format_to(std::back_inserter(out), "{{\"name\":\"");
+		for (const char* c = evt.Name; *c != '\0'; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				out.push_back('\\');
+			out.push_back(*c);
+		}
+
+		fmt::format_to(std::back_inserter(out), "\",\"ph\":\"{0}\",\"ts\":{1:.3f},\"pid\":1,\"tid\":{2}}}",
+			char(evt.Phase), evt.Time / 1000.0, threadId);
+
+		m_File.write(out.data(), out.size());
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bsf
+{
+	enum class ETracePhase : char
+	{
+		Begin = 'B',
+		End = 'E'
+	};
+
+	// Records begin/end events of diagnostic scopes and writes them as a Chrome trace
+	// (chrome://tracing, Perfetto). Each thread writes to its own buffer without locking,
+	// buffers are drained to the file by Flush
+	class TraceRecorder
+	{
+	public:
+		static TraceRecorder& Get();
+
+		~TraceRecorder();
+
+		bool Start(const std::string& path);
+		void Flush();
+		void Stop();
+
+		static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+		static void Record(const char* name, ETracePhase phase);
+
+	private:
+		struct Event
+		{
+			const char* Name;
+			int64_t Time;
+			ETracePhase Phase;
+		};
+
+		struct Chunk
+		{
+			static constexpr uint32_t Capacity = 4096;
+			std::array<Event, Capacity> Events;
+			std::atomic<uint32_t> Count = 0;
+			std::atomic<Chunk*> Next = nullptr;
+		};
+
+		// Tail is only touched by the owner thread, Head and Flushed only by Drain
+		struct Buffer
+		{
+			uint32_t ThreadId = 0;
+			Chunk* Head = nullptr;
+			Chunk* Tail = nullptr;
+			uint32_t Flushed = 0;
+		};
+
+		TraceRecorder() = default;
+
+		static Buffer& GetThreadBuffer();
+		bool Close();
+		void Drain(bool write);
+		void WriteEvent(const Event& evt, uint32_t threadId);
+
+		inline static std::atomic<bool> s_Enabled = false;
+
+		std::mutex m_Mutex;
+		std::vector<std::unique_ptr<Buffer>> m_Buffers;
+		std::ofstream m_File;
+		bool m_FirstEvent = true;
+	};
+
+	struct TraceGuard
+	{
+	public:
+		TraceGuard(const char* name) : m_Name(name), m_Active(TraceRecorder::IsEnabled())
+		{
+			if (m_Active)
+				TraceRecorder::Record(m_Name, ETracePhase::Begin);
+		}
+
+		~TraceGuard()
+		{
+			if (m_Active)
+				TraceRecorder::Record(m_Name, ETracePhase::End);
+		}
+
+	private:
+		const char* m_Name;
+		bool m_Active;
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace bsf
+{
+	// Hands the latest value from a writer thread to a reader thread without locking.
+	// The writer fills the write buffer and publishes it, the reader picks up the most
+	// recently published buffer (older ones are skipped). Neither side ever waits
+	template<typename T>
+	class TripleBuffer
+	{
+	public:
+
+		// Writer side
+		T& GetWriteBuffer() { return m_Buffers[m_WriteIndex]; }
+
+		void Publish()
+		{
+			m_WriteIndex = m_Shared.exchange(m_WriteIndex | s_Fresh, std::memory_order_acq_rel) & s_IndexMask;
+		}
+
+		// Reader side, returns false if nothing was published since the last call
+		bool Update()
+		{
+			if ((m_Shared.load(std::memory_order_relaxed) & s_Fresh) == 0)
+				return false;
+
+			m_ReadIndex = m_Shared.exchange(m_ReadIndex, std::memory_order_acq_rel) & s_IndexMask;
+			return true;
+		}
+
+		const T& GetReadBuffer() const { return m_Buffers[m_ReadIndex]; }
+
+	private:
+		static constexpr uint8_t s_IndexMask = 0x3;
+		static constexpr uint8_t s_Fresh = 0x4;
+
+		std::array<T, 3> m_Buffers = {};
+		uint8_t m_WriteIndex = 0;
+		uint8_t m_ReadIndex = 1;
+		std::atomic<uint8_t> m_Shared = 2;
+	};
+}
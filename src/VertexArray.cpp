@@ -115,15 +115,29 @@ namespace bsf
 	void VertexArray::DrawArrays(GLenum mode, uint32_t count)
 	{
 		Bind();
+		BSF_GLSTAT(DrawCalls);
 		BSF_GLCALL(glDrawArrays(mode, 0, count));
 	}
 
 	void VertexArray::DrawIndexed(GLenum mode)
 	{
 		assert(m_IndexBuffer != nullptr);
+		DrawIndexed(mode, m_IndexBuffer->GetCount());
+	}
+
+	void VertexArray::DrawIndexed(GLenum mode, uint32_t count, int32_t baseVertex)
+	{
+		assert(m_IndexBuffer != nullptr && count <= m_IndexBuffer->GetCount());
 		Bind();
 		m_IndexBuffer->Bind();
-		glDrawElements(mode, m_IndexBuffer->GetCount(), s_GLAttrDescr.Get<0, 1>(m_IndexBuffer->GetType()).Type, 0);
+		BSF_GLSTAT(DrawCalls);
+
+		const GLenum type = s_GLAttrDescr.Get<0, 1>(m_IndexBuffer->GetType()).Type;
+
+		if (baseVertex == 0)
+			glDrawElements(mode, count, type, 0);
+		else
+			glDrawElementsBaseVertex(mode, count, type, 0, baseVertex);
 	}
 
 	void VertexArray::Draw(GLenum mode)
@@ -164,6 +178,8 @@ namespace bsf
 
 		BSF_GLCALL(glGenBuffers(1, &m_Id));
 		Bind();
+		BSF_GLSTAT(BufferUploads);
+		BSF_GLSTAT_ADD(BufferUploadBytes, m_VertexSize * count);
 		glBufferData(GL_ARRAY_BUFFER, m_VertexSize * count, data, usage);
 
 	}
@@ -185,9 +201,33 @@ namespace bsf
 	void VertexBuffer::SetSubData(const void* data, uint32_t offset, uint32_t count)
 	{
 		Bind();
+		BSF_GLSTAT(BufferUploads);
+		BSF_GLSTAT_ADD(BufferUploadBytes, count * m_VertexSize);
 		glBufferSubData(GL_ARRAY_BUFFER, offset * m_VertexSize, count * m_VertexSize, data);
 	}
 
+	void* VertexBuffer::MapRange(uint32_t offset, uint32_t count, GLbitfield access)
+	{
+		assert(offset + count <= m_Count);
+		Bind();
+		BSF_GLSTAT(BufferUploads);
+		return glMapBufferRange(GL_ARRAY_BUFFER, offset * m_VertexSize, count * m_VertexSize, access);
+	}
+
+	void VertexBuffer::FlushMappedRange(uint32_t offset, uint32_t count)
+	{
+		Bind();
+		BSF_GLSTAT_ADD(BufferUploadBytes, count * m_VertexSize);
+		BSF_GLCALL(glFlushMappedBufferRange(GL_ARRAY_BUFFER, offset * m_VertexSize, count * m_VertexSize));
+	}
+
+	void VertexBuffer::Unmap()
+	{
+		Bind();
+		if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+			BSF_ERROR("Vertex buffer data has been lost while mapped");
+	}
+
 	IndexBuffer::IndexBuffer(const void* data, AttributeType type, size_t count) : m_Count(count)
 	{
 
@@ -197,7 +237,10 @@ namespace bsf
 
 		BSF_GLCALL(glGenBuffers(1, &m_Id));
 		BSF_GLCALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Id));
-		BSF_GLCALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * s_GLAttrDescr.Get<0, 1>(type).ElementSize, data, GL_STATIC_DRAW));
+		const size_t size = count * s_GLAttrDescr.Get<0, 1>(type).ElementSize;
+		BSF_GLSTAT(BufferUploads);
+		BSF_GLSTAT_ADD(BufferUploadBytes, size);
+		BSF_GLCALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 	}
 
 	IndexBuffer::~IndexBuffer()
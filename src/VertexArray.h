@@ -64,6 +64,12 @@ namespace bsf
 
 		void SetSubData(const void* data, uint32_t offset, uint32_t count);
 
+		// Offsets and counts are in vertices. FlushMappedRange is relative to the mapped range
+		// and needed only with GL_MAP_FLUSH_EXPLICIT_BIT
+		void* MapRange(uint32_t offset, uint32_t count, GLbitfield access);
+		void FlushMappedRange(uint32_t offset, uint32_t count);
+		void Unmap();
+
 		uint32_t GetId() const { return m_Id; }
 		uint32_t GetVertexCount() const { return m_Count; }
 		uint32_t GetVertexSize() const { return m_VertexSize; }
@@ -95,6 +101,7 @@ namespace bsf
 		void DrawArrays(GLenum mode);
 		void DrawArrays(GLenum mode, uint32_t count);
 		void DrawIndexed(GLenum mode);
+		void DrawIndexed(GLenum mode, uint32_t count, int32_t baseVertex = 0);
 		void Draw(GLenum mode);
 
 		void SetVertexBuffer(uint32_t index, const Ref<VertexBuffer>& buffer);
@@ -0,0 +1,84 @@
+#version 330 core
+
+// Values of EStageObject
+const uint OBJ_NONE = 0u;
+const uint OBJ_RING = 4u;
+
+uniform usampler2D uStage; // r: object, g: avoid search
+uniform int uStageSize;
+
+uniform sampler2D uBackground;
+uniform vec4 uBackgroundColor;
+uniform sampler2D uPattern;
+
+// Sprites can be atlas views, their rects are xy: uv offset, zw: uv scale
+uniform sampler2D uSphere;
+uniform vec4 uSphereRect;
+uniform sampler2D uRing;
+uniform vec4 uRingRect;
+uniform sampler2D uAvoidSearch;
+uniform vec4 uAvoidSearchRect;
+
+uniform vec4 uObjectColors[7];
+uniform vec4 uAvoidSearchColor;
+uniform vec4 uShadowColor;
+uniform vec2 uShadowOffset; // In cells
+
+in vec2 fWorld;
+
+out vec4 oColor;
+
+// Gradients of fWorld, taken in uniform control flow
+vec2 gWorldDx, gWorldDy;
+
+// Cell at the given world position, zero outside the stage
+uvec2 GetCell(vec2 world) {
+    ivec2 cell = ivec2(floor(world));
+
+    if(any(lessThan(cell, ivec2(0))) || any(greaterThanEqual(cell, ivec2(uStageSize))))
+        return uvec2(0u);
+
+    return texelFetch(uStage, cell, 0).rg;
+}
+
+// Explicit gradients, the ones of fract() jump at the cell edges
+vec4 SampleSprite(sampler2D sprite, vec4 rect, vec2 world) {
+    return textureGrad(sprite, rect.xy + fract(world) * rect.zw, gWorldDx * rect.zw, gWorldDy * rect.zw);
+}
+
+vec4 SampleObject(uint obj, vec2 world) {
+    return obj == OBJ_RING ? SampleSprite(uRing, uRingRect, world) : SampleSprite(uSphere, uSphereRect, world);
+}
+
+vec3 Over(vec3 dst, vec4 src) {
+    return mix(dst, src.rgb, src.a);
+}
+
+void main() {
+    gWorldDx = dFdx(fWorld);
+    gWorldDy = dFdy(fWorld);
+
+    vec3 color = (texture(uBackground, fWorld / 2.0 + 0.25) * uBackgroundColor).rgb;
+
+    if(all(greaterThanEqual(fWorld, vec2(0.0))) && all(lessThan(fWorld, vec2(uStageSize))))
+        color = Over(color, texture(uPattern, fWorld / 2.0 - 0.25));
+
+    // Shadows come from the cell they've been offset from
+    vec2 shadowWorld = fWorld - uShadowOffset;
+    uvec2 shadowCell = GetCell(shadowWorld);
+    uvec2 cell = GetCell(fWorld);
+
+    if(shadowCell.r != OBJ_NONE)
+        color = Over(color, SampleObject(shadowCell.r, shadowWorld) * uShadowColor);
+
+    if(cell.r != OBJ_NONE)
+        color = Over(color, SampleObject(cell.r, fWorld) * uObjectColors[cell.r]);
+
+    if(shadowCell.g != 0u)
+        color = Over(color, SampleSprite(uAvoidSearch, uAvoidSearchRect, shadowWorld) * uShadowColor);
+
+    if(cell.g != 0u)
+        color = Over(color, SampleSprite(uAvoidSearch, uAvoidSearchRect, fWorld) * uAvoidSearchColor);
+
+    oColor = vec4(color, 1.0);
+}
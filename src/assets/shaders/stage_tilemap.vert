@@ -0,0 +1,16 @@
+#version 330 core
+
+layout(location = 0) in vec2 aPosition;
+
+uniform mat4 uProjection;
+uniform vec4 uBounds; // xy: position, zw: size
+uniform vec2 uViewOrigin;
+uniform float uZoom;
+
+out vec2 fWorld;
+
+void main() {
+    vec2 local = (aPosition * 0.5 + 0.5) * uBounds.zw;
+    fWorld = uViewOrigin + local / uZoom;
+    gl_Position = uProjection * vec4(uBounds.xy + local, 0.0, 1.0);
+}